@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Objects of a level whose replicated state changed since the last snapshot.
+ * Objects mark themselves from their setters (Object::markDirty), which set a
+ * flag in a table indexed by object ID and append the ID to a list the first
+ * time, so finding and clearing the changes costs O(changed) instead of
+ * comparing every object against a copy of its previous state.
+ * Not thread safe: owned by the level and only used by the thread updating it.
+ */
+class DirtyTracker {
+public:
+    void mark(uint16_t id) {
+        if (id >= flags_.size()) {
+            grow(id);
+        }
+        if (!flags_[id]) {
+            flags_[id] = 1;
+            ids_.push_back(id);
+        }
+    }
+
+    bool isDirty(uint16_t id) const { return id < flags_.size() && flags_[id]; }
+    // Marked IDs in marking order, each once
+    const std::vector<uint16_t>& dirtyIds() const { return ids_; }
+    bool empty() const { return ids_.empty(); }
+
+    // Unmark everything; the table keeps its size
+    void clear();
+
+private:
+    void grow(uint16_t id);
+
+    std::vector<uint8_t> flags_;
+    std::vector<uint16_t> ids_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Hands out the object IDs of one game session. IDs are 16 bit and every
+ * level load takes one per tile, so each session numbers its own objects
+ * instead of sharing a process-wide counter: sessions running side by side
+ * can neither collide nor use up each other's ID space. Thread safe, levels
+ * load on the game loop while connections get their player ID on the
+ * network threads.
+ */
+class ObjectIdAllocator {
+public:
+    uint16_t next() { return next_.fetch_add(1, std::memory_order_relaxed); }
+    // IDs handed out so far
+    uint16_t count() const { return next_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint16_t> next_{0};
+};
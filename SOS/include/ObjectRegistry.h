@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "object.h"
+
+/**
+ * Objects keyed by their uint16_t object ID. IDs are handed out densely
+ * (ObjectIdAllocator), so the registry is a plain table indexed by ID
+ * that grows to the largest ID seen: lookup, insert and remove are O(1).
+ * It does not define an order; Game keeps its object list for that.
+ */
+class ObjectRegistry {
+public:
+    // Returns false (and keeps the existing object) if the ID is taken
+    bool insert(const std::shared_ptr<Object>& object);
+    // Returns false if no object has the ID
+    bool remove(uint16_t id);
+    void clear();
+
+    // Null if no object has the ID
+    const std::shared_ptr<Object>& find(uint16_t id) const {
+        return id < slots_.size() ? slots_[id] : empty_;
+    }
+    bool contains(uint16_t id) const { return find(id) != nullptr; }
+    size_t size() const { return count_; }
+
+private:
+    std::vector<std::shared_ptr<Object>> slots_;
+    size_t count_ = 0;
+    static const std::shared_ptr<Object> empty_;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -90,8 +91,15 @@ public:
 
     // Cleanup shared resources
     static void cleanupSharedResources();
+
+    // Headless mode (dedicated server): sprite sheets are never opened, frame counts
+    // come from a built-in table instead. Set before any object is created.
+    static void setHeadless(bool headless);
+    static bool isHeadless();
     
     void addSpriteSheet(const std::string& spriteSheetPath, AnimationState spriteState, uint32_t frameTime = 150);
+    // Use a sprite sheet that is already loaded
+    void addSpriteSheet(SpriteData* spriteData, AnimationState spriteState, uint32_t frameTime = 150);
 
     // Add an animation definition for a specific state
     void addAnimation(AnimationState state, const AnimationDef& def);
@@ -126,4 +134,6 @@ private:
     int currentFrame;
     uint32_t elapsedTime;
     bool finished;
+
+    static std::atomic<bool> headless_;
 };
\ No newline at end of file
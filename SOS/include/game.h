@@ -23,6 +23,7 @@
 #include "player_manager.h"
 #include "ServerConfig.h"
 #include "level_manager.h"
+#include "ObjectRegistry.h"
 
 enum class GameState {
     RUNNING,
@@ -48,7 +49,8 @@ public:
     std::string generateRandomPlayerId();
     
     // Multiplayer functionality
-    bool initializeServerConnection(const std::string& serverAddress, int serverPort, const uint16_t playerId);
+    bool initializeServerConnection(const std::string& serverAddress, int serverPort, const uint16_t playerId,
+                                    const std::string& levelId = "");
 
     // New: Initialize single player mode with embedded server
     bool initializeSinglePlayerEmbeddedServer();
@@ -77,6 +79,8 @@ public:
 
     // Method to add a game object dynamically
     void addObject(std::shared_ptr<Object> object);
+    // O(1) lookup by object ID, null if there is no such object
+    const std::shared_ptr<Object>& findObject(uint16_t objectId) const { return objectRegistry_.find(objectId); }
     
     // Static instance getter for singleton access
     static Game* getInstance() { return instance_; }
@@ -107,7 +111,8 @@ private:
     GameState state;
     bool running;
     bool isPaused = false;
-    std::vector<std::shared_ptr<Object>> objects;
+    std::vector<std::shared_ptr<Object>> objects; // Update and draw order, the local player last
+    ObjectRegistry objectRegistry_; // Every object in objects, by ID
     std::vector<Actor*> actors; //Non-interactive objects i.e. text, background, etc.
     SpriteData* letters;
     SpriteData* letters_small;
@@ -6,21 +6,26 @@
 #include <mutex>
 
 #include "object.h"
+#include "ObjectRegistry.h"
+#include "ObjectIdAllocator.h"
 #include "collision/CollisionManager.h"
 #include "objects/tile.h"
 #include "objects/enemy.h"
 #include "objects/minotaur.h"
 #include "objects/player.h"
 #include "factories/player_factory.h"
+#include "utils/TickProfiler.h"
 
 #include <nlohmann/json.hpp>
 
 class Level
 {
 public:
+    // New objects get their IDs from objectIds, shared by every level of the session
     Level(const std::string& id,
           const std::string& name,
-          CollisionManager* collisionManager);
+          CollisionManager* collisionManager,
+          ObjectIdAllocator* objectIds);
     ~Level();
 
     /* -------- life-cycle -------- */
@@ -35,16 +40,36 @@ public:
     const std::vector<std::shared_ptr<Object>>& getObjects()  const { return levelObjects; }
     std::string                          getBackgroundPath() const { return backgroundPath; }
     Vec2                                 getPlayerStartPosition() const { return playerStartPosition; }
+    // Every object that is not a tile
+    const std::vector<std::shared_ptr<Object>>& getDynamicObjects() const { return dynamicObjects_; }
+    // Object of the level with the ID, or null
+    Object*                              findObject(uint16_t id) const { return objectsById_.find(id).get(); }
+    // Same, for callers that need to hold on to the object or remove it
+    const std::shared_ptr<Object>&       findSharedObject(uint16_t id) const { return objectsById_.find(id); }
+    // Tileset names in load order, a tile's tileset index points into this.
+    // Loading a level replaces the table, it never changes while shared.
+    const std::shared_ptr<const std::vector<std::string>>& getTilesetNames() const { return tilesetNames_; }
 
     /* -------- object management -------- */
     void addObject   (std::shared_ptr<Object> object);
     void removeObject(std::shared_ptr<Object> object);
     bool removeAllObjects();
 
+    /* -------- replication -------- */
+    // Objects whose replicated state changed since the last snapshot of the level
+    DirtyTracker& getDirtyTracker() { return dirtyTracker_; }
+
     /* -------- level status -------- */
     bool isCompleted() const { return completed; }
     void setCompleted(bool v){ completed = v;    }
 
+    /* -------- profiling ----------- */
+    void setProfiler(TickProfiler* p) { profiler_ = p; }   // may be null
+
+    /* -------- load shedding ------- */
+    // Entities far from every player only update every stride-th tick (1 = every tick)
+    void setDistantUpdateStride(int stride) { distantUpdateStride_ = stride > 0 ? stride : 1; }
+
     /* -------- tile helpers -------- */
     bool isCollidableTile(int localTileId,
                           const std::string& tilesetName);
@@ -79,6 +104,12 @@ private:
     /* ---------- collision -------------- */
     void detectAndResolveCollisions();
 
+    /* ---------- replication ------------ */
+    // Add to the object lists and the ID lookup. Objects report their changes to the
+    // level while they are in it, a new one is all changes. False if the ID is taken.
+    bool insertObject(const std::shared_ptr<Object>& object);
+    void untrackObjects();
+
 private:
     /* ---------- core data -------------- */
     std::string id;                 // “level1”
@@ -91,12 +122,22 @@ private:
     bool completed= false;
 
     std::vector<std::shared_ptr<Object>> levelObjects;
+    std::vector<std::shared_ptr<Object>> dynamicObjects_;
+    ObjectRegistry                       objectsById_;
+    DirtyTracker                         dirtyTracker_;
     std::vector<TilesetInfo>             tilesets_;
+    std::shared_ptr<const std::vector<std::string>> tilesetNames_ =
+        std::make_shared<const std::vector<std::string>>();
 
     /* map-wide tile metrics */
     int tileWidth  = 32;
     int tileHeight = 32;
 
     CollisionManager* collisionManager = nullptr;
+    ObjectIdAllocator* objectIds_      = nullptr;
+    TickProfiler*     profiler_        = nullptr;
+    int               distantUpdateStride_ = 1;
+    std::vector<Vec2> playerPositions_;    // Reused by update() while shedding load
+    uint64_t          updateCount_     = 0;
     mutable std::mutex gameStateMutex_;
 };
@@ -3,26 +3,44 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_set>
 #include <memory>
 #include <filesystem>
 #include <fstream>
 #include "level.h"
+#include "player_manager.h"
+#include "ObjectIdAllocator.h"
 #include "collision/CollisionManager.h"
+#include "utils/WorkerPool.h"
 
 
 class LevelManager {
 public:
-    LevelManager(const std::filesystem::path& basePath);
+    // parallelUpdate ticks the active levels on a worker pool, only worth it for a server
+    // that simulates several levels at once. The pool is started when a second level
+    // becomes active.
+    explicit LevelManager(const std::filesystem::path& basePath, bool parallelUpdate = false);
     ~LevelManager();
 
     // Initialize the level manager and load all level metadata
     bool initialize();
     
-    // Load and activate a specific level
+    // Load and activate a specific level, making it the default for new players
     bool loadLevel(const std::string& levelId);
+
+    // Load a level (if needed) and add it to the set of simulated levels.
+    // A level stops being simulated once its last player left, it keeps its state
+    // and continues where it was when a player enters it again.
+    Level* activateLevel(const std::string& levelId);
     
-    // Get the currently active level
+    // Get the default level new players join
     Level* getCurrentLevel() const;
+
+    // All levels that are currently simulated
+    const std::vector<std::shared_ptr<Level>>& getActiveLevels() const { return activeLevels_; }
+
+    // Level a player is in, or null
+    Level* getLevelForPlayer(uint16_t playerId) const;
     
     // Get a specific level by ID
     Level* getLevel(const std::string& levelId);
@@ -36,8 +54,14 @@ public:
     // Reset the current level
     void resetCurrentLevel();
     
-    // Update the currently active level
+    // Update all active levels, in parallel on the worker pool if there is one
     void update(float deltaTime);
+
+    // Attach a tick profiler to all levels (null to disable)
+    void setProfiler(TickProfiler* profiler);
+
+    // Update stride for entities far from every player, applied to active levels on update
+    void setDistantUpdateStride(int stride) { distantUpdateStride_ = stride; }
     
     // Check if all levels have been completed
     bool areAllLevelsCompleted() const;
@@ -51,10 +75,38 @@ public:
     bool removeAllPlayersFromCurrentLevel();
     bool removeAllObjectsFromCurrentLevel();
 
+    // Add a player to a specific level (activating it), moving it out of its previous level
+    bool addPlayerToLevel(uint16_t playerId, const std::string& levelId);
+    // Remove a player from whichever level it is in
+    bool removePlayer(uint16_t playerId);
+
+    // Remove all objects and players from every loaded level, active or not, so
+    // the next loadLevel() reads them from their files again
+    void clearLoadedLevels();
+
+    // The session's players and object IDs, shared by all of its levels
+    PlayerManager& getPlayerManager() { return playerManager_; }
+    ObjectIdAllocator& getObjectIds() { return objectIds_; }
+
 private:
-    CollisionManager* collisionManager;
+    // Take the player out of its level and return that level (null if it was in none)
+    std::shared_ptr<Level> detachPlayer(uint16_t playerId);
+    // Stop simulating the level if no player is in it anymore
+    void deactivateIfEmpty(const std::shared_ptr<Level>& level);
+
+    TickProfiler* profiler_ = nullptr;
+    int distantUpdateStride_ = 1;
+    bool parallelUpdate_ = false;
+    std::unique_ptr<WorkerPool> workerPool_;
 private:
+    ObjectIdAllocator objectIds_;
+    PlayerManager playerManager_;
+    std::unordered_map<std::string, std::unique_ptr<CollisionManager>> collisionManagers_;
     std::unordered_map<std::string, std::shared_ptr<Level>> levels_;
+    std::vector<std::shared_ptr<Level>> activeLevels_;
+    // Levels read from their file before, reactivating them does not load them again
+    std::unordered_set<std::string> loadedLevels_;
+    std::unordered_map<uint16_t, std::shared_ptr<Level>> playerLevels_;
     std::shared_ptr<Level> currentLevel_;
     std::string currentJsonFilePath_;
     std::unordered_map<std::string, std::filesystem::path> levelFilePaths_;
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "NetworkInterface.h"
+#include "network/DatagramChannel.h"
+#include "utils/BufferPool.h"
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
-#include <queue>
+#include <vector>
+#include <array>
 #include <mutex>
+#include <atomic>
 #include <optional>
 
 #include <boost/bind/bind.hpp>
@@ -28,13 +32,29 @@ private:
     // Asio-specific implementation details
     void handleConnect(const boost::system::error_code& error);
     void startRead();
-    void handleRead(const boost::system::error_code& error, size_t bytesTransferred);
+    void readBody(uint32_t size);
+    void queueMessage(NetworkMessage&& message);
+    // Split a BUNDLE into its messages and queue them in one pass
+    void unpackBundle(const NetworkMessage& bundle);
+    // Turn GAME_STATE_COMPRESSED into the GAME_STATE it carries; false if it is corrupt
+    bool inflateGameState(NetworkMessage& message);
     void handleWrite(const boost::system::error_code& error);
     void processMessageQueue();
 
+    // UDP side channel offered by the server: snapshots and input switch to it
+    // once a handshake datagram made it both ways, TCP carries everything else
+    void handleUdpOffer(const NetworkMessage& message);
+    void sendUdpHello();
+    void handleDatagram(const DatagramChannel::Endpoint& from, uint32_t sequence,
+                        const uint8_t* body, size_t size);
+
     // Network message serialization/deserialization
     std::vector<uint8_t> serializeMessage(const NetworkMessage& message);
-    NetworkMessage deserializeMessage(const std::vector<uint8_t>& data);
+    // Parses in place; the payload is copied once, into a pooled buffer
+    NetworkMessage deserializeMessage(const uint8_t* data, size_t size);
+    // [type u8][sender u16 BE][data length u32 BE] in front of every payload
+    static constexpr size_t MessageBodyHeaderSize = 1 + sizeof(uint16_t) + sizeof(uint32_t);
+    static void decodeMessageHeader(const uint8_t* header, NetworkMessage& message, uint32_t& dataSize);
 
     
 private:
@@ -57,15 +77,34 @@ private:
     
     // Message handling
     std::function<void(const NetworkMessage&)> message_handler_;
-    std::queue<NetworkMessage> received_messages_;
+    // The IO thread appends under message_mutex_; the game thread swaps the whole
+    // batch out and runs the handler without the lock, so reads never wait on it
+    std::vector<NetworkMessage> received_messages_;
+    std::vector<NetworkMessage> processing_messages_;  // Game thread only
+    std::vector<NetworkMessage> bundle_messages_;      // IO thread only, the bundle being unpacked
     std::mutex message_mutex_;
     
-    // Message read buffer
-    enum { max_buffer_size = 8192 };
-    std::vector<uint8_t> read_buffer_;
+    // UDP side channel (handshake runs on the IO thread)
+    DatagramChannel udp_channel_;
+    DatagramChannel::Endpoint udp_server_endpoint_;
+    boost::asio::steady_timer udp_hello_timer_;
+    uint32_t udp_token_ = 0;
+    int udp_hello_attempts_ = 0;
+    std::atomic<bool> udp_active_{false};
+    std::atomic<bool> udp_ready_pending_{false};  // UDP_READY still has to go out over TCP
+    std::atomic<uint32_t> udp_send_sequence_{0};
+    uint32_t udp_last_received_ = 0;
+    bool udp_received_any_ = false;
     
     // Message header contains the size of the following message
     struct MessageHeader {
         uint32_t size;
     };
+    
+    // Read state (IO thread only). The payload is read straight into a pooled buffer
+    // that becomes the message data, and goes back to the pool once it was handled.
+    MessageHeader read_header_;
+    std::array<uint8_t, MessageBodyHeaderSize> read_message_header_;
+    BufferPool::Buffer read_payload_;
+    BufferPool buffer_pool_;
 };
\ No newline at end of file
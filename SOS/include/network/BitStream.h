@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bit-level writer and reader for packed network payloads. Values are
+ * stored least significant bit first and a stream is padded with zero bits
+ * to a whole byte when finished. Varints use groups of 7 bits with a
+ * continuation bit, so small ids and counts take one group.
+ */
+class BitWriter {
+public:
+    // Appends to out; call finish() before using the bytes
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    // Write the low bits of value, bits <= 32
+    void write(uint32_t value, unsigned bits) {
+        if (bits < 32) {
+            value &= (uint32_t(1) << bits) - 1;
+        }
+        scratch_ |= static_cast<uint64_t>(value) << scratchBits_;
+        scratchBits_ += bits;
+        while (scratchBits_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(scratch_ & 0xFF));
+            scratch_ >>= 8;
+            scratchBits_ -= 8;
+        }
+    }
+
+    void writeFlag(bool value) { write(value ? 1 : 0, 1); }
+
+    void writeVarint(uint32_t value) {
+        while (value >= 0x80) {
+            write((value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+        write(value, 8);
+    }
+
+    // Zigzag, so small negative numbers stay small
+    void writeSignedVarint(int32_t value) {
+        writeVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    // Pad the last byte with zero bits
+    void finish() {
+        if (scratchBits_ > 0) {
+            out_.push_back(static_cast<uint8_t>(scratch_ & 0xFF));
+            scratch_ = 0;
+            scratchBits_ = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t scratch_ = 0;
+    unsigned scratchBits_ = 0;
+};
+
+// Reads what BitWriter wrote; reading past the end returns zeros and turns ok() false
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint32_t read(unsigned bits) {
+        while (scratchBits_ < bits) {
+            if (pos_ == size_) {
+                ok_ = false;
+                return 0;
+            }
+            scratch_ |= static_cast<uint64_t>(data_[pos_++]) << scratchBits_;
+            scratchBits_ += 8;
+        }
+        const uint32_t value = bits < 32 ? static_cast<uint32_t>(scratch_ & ((uint64_t(1) << bits) - 1))
+                                         : static_cast<uint32_t>(scratch_);
+        scratch_ >>= bits;
+        scratchBits_ -= bits;
+        return value;
+    }
+
+    bool readFlag() { return read(1) != 0; }
+
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (unsigned shift = 0; shift < 35 && ok_; shift += 7) {
+            const uint32_t group = read(8);
+            value |= (group & 0x7F) << shift;
+            if (!(group & 0x80)) {
+                return value;
+            }
+        }
+        ok_ = false;  // Longer than any 32-bit value
+        return 0;
+    }
+
+    int32_t readSignedVarint() {
+        const uint32_t value = readVarint();
+        return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t scratch_ = 0;
+    unsigned scratchBits_ = 0;
+    bool ok_ = true;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/asio.hpp>
+
+#include "network/DatagramChannel.h"
+
+/**
+ * Server side of one client connection with a coalescing send queue.
+ * Frames are complete wire messages (header included) and are shared, so the
+ * same frame can be queued on several connections. Queued frames wait in a
+ * ring; only one write is in flight at a time and each flush gathers every
+ * frame queued so far into a single vectored async_write.
+ *
+ * The queue is bounded so a slow client cannot grow server memory:
+ * - State frames (deltas) are latest-only. While the client is still busy
+ *   with earlier state, a newer state frame drops the queued one and is
+ *   queued at the end, so it never overtakes reliable frames queued after
+ *   the old one. Above the high-water mark state is not queued at all.
+ *   Either way the client has missed changes and is flagged for a
+ *   full-state resync, which the server sends once the backlog has drained.
+ * - Heartbeats are dropped whenever other state is already waiting.
+ * - Reliable frames are always queued; a backlog beyond the limit closes
+ *   the connection.
+ */
+class ClientConnection : public std::enable_shared_from_this<ClientConnection> {
+public:
+    using Frame = std::shared_ptr<const std::vector<uint8_t>>;
+
+    enum class FrameKind : uint8_t {
+        Reliable,   // Must arrive (joins, full state, events)
+        State,      // Game state delta, superseded by the next one
+        Heartbeat,  // Only says the server is alive
+    };
+
+    // The socket must be bound to its own strand, writes are started on it
+    ClientConnection(std::shared_ptr<boost::asio::ip::tcp::socket> socket, uint16_t playerId);
+
+    ClientConnection(const ClientConnection&) = delete;
+    ClientConnection& operator=(const ClientConnection&) = delete;
+
+    // Queue a frame for sending; safe to call from any thread. Returns false if the
+    // frame was dropped or the connection is closed (or was closed by this call).
+    bool send(Frame frame, FrameKind kind = FrameKind::Reliable);
+
+    // Close the socket on its strand; pending frames are dropped
+    void close();
+
+    bool isOpen() const;
+    uint16_t getPlayerId() const { return playerId_; }
+    const std::shared_ptr<boost::asio::ip::tcp::socket>& getSocket() const { return socket_; }
+
+    // Bytes queued or being written
+    size_t getQueuedBytes() const { return queuedBytes_.load(std::memory_order_relaxed); }
+
+    // True once if state was dropped and the backlog has drained enough for a full state
+    bool takeResyncRequest();
+    // State frames replaced or dropped so far
+    uint64_t getDroppedStateFrames() const { return droppedStateFrames_.load(std::memory_order_relaxed); }
+    // The connection was closed because its backlog exceeded the limit
+    bool isOverflowed() const { return overflowed_.load(std::memory_order_relaxed); }
+
+    // The client asked for GAME_STATE_COMPRESSED in its CONNECT message
+    void setCompressedState(bool enabled) { compressedState_.store(enabled, std::memory_order_relaxed); }
+    bool acceptsCompressedState() const { return compressedState_.load(std::memory_order_relaxed); }
+
+    // UDP side channel. The token is offered over TCP and proves the client's
+    // datagram endpoint; snapshots use UDP once the client confirmed the echo.
+    uint32_t getUdpToken() const { return udpToken_; }
+    void setUdpEndpoint(const DatagramChannel::Endpoint& endpoint);
+    bool getUdpEndpoint(DatagramChannel::Endpoint& endpoint) const;
+    // Returns false if no endpoint was bound yet
+    bool activateUdp();
+    bool isUdpActive() const { return udpActive_.load(std::memory_order_acquire); }
+    // UDP receive strand only: true if the datagram is newer than every one before it
+    bool acceptUdpSequence(uint32_t sequence);
+
+private:
+    // Strand only: gather the queue into one write
+    void flush();
+    void handleWrite(const boost::system::error_code& error);
+
+    struct QueuedFrame {
+        Frame frame;
+        FrameKind kind = FrameKind::Reliable;
+    };
+
+    // Ring of pending frames, grows by doubling when full (guarded by queueMutex_).
+    // A superseded state frame stays in its slot with a null frame until popped.
+    void pushFrame(Frame frame, FrameKind kind);
+    QueuedFrame popFrame();
+    // Queue position of the state or heartbeat frame waiting in the ring, if any
+    QueuedFrame* queuedStateFrame();
+
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket_;
+    uint16_t playerId_;
+    std::atomic<bool> closed_{false};
+
+    std::mutex queueMutex_;
+    std::vector<QueuedFrame> ring_;
+    size_t ringHead_ = 0;
+    size_t ringCount_ = 0;
+    bool writing_ = false;  // A flush is scheduled or a write is in flight
+    bool reliableInFlight_ = false;  // The write in flight carries a reliable frame
+    // Absolute queue positions; stateFramePosition_ is valid while >= poppedFrames_
+    uint64_t pushedFrames_ = 0;
+    uint64_t poppedFrames_ = 0;
+    uint64_t stateFramePosition_ = 0;
+    bool stateFrameQueued_ = false;
+
+    // Strand only: the frames of the write in flight and their buffers, reused between writes
+    std::vector<Frame> inFlight_;
+    std::vector<boost::asio::const_buffer> gatherBuffers_;
+
+    std::atomic<size_t> queuedBytes_{0};
+    std::atomic<bool> resyncNeeded_{false};
+    std::atomic<bool> overflowed_{false};
+    std::atomic<uint64_t> droppedStateFrames_{0};
+    std::atomic<bool> compressedState_{false};
+
+    const uint32_t udpToken_;
+    mutable std::mutex udpMutex_;
+    DatagramChannel::Endpoint udpEndpoint_;  // Guarded by udpMutex_
+    bool udpEndpointBound_ = false;          // Guarded by udpMutex_
+    std::atomic<bool> udpActive_{false};
+    uint32_t lastUdpSequence_ = 0;
+    bool udpSequenceSeen_ = false;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/asio.hpp>
+
+#include "network/NetworkMessage.h"
+
+/**
+ * Unreliable side channel for state that is only worth its latest value
+ * (snapshots, input). Every datagram carries one message prefixed with a
+ * sequence number, so receivers can drop anything older than what they
+ * already applied. The body after the sequence number is laid out like a
+ * TCP message body, so both sides reuse their own deserializeMessage().
+ * The socket lives on its own strand; send() may be called from any thread.
+ * Used by both the client and the server.
+ *
+ * Datagram layout: [sequence u32 BE][type u8][sender u16 BE][data length u32 BE][data]
+ */
+class DatagramChannel {
+public:
+    using Datagram = std::shared_ptr<const std::vector<uint8_t>>;
+    using Endpoint = boost::asio::ip::udp::endpoint;
+    // The body points into the receive buffer and is only valid during the call
+    using ReceiveHandler = std::function<void(const Endpoint& from, uint32_t sequence, const uint8_t* body, size_t size)>;
+
+    static constexpr size_t HeaderSize = sizeof(uint32_t) + 1 + sizeof(uint16_t) + sizeof(uint32_t);
+
+    explicit DatagramChannel(boost::asio::io_context& io_context);
+    ~DatagramChannel();
+
+    DatagramChannel(const DatagramChannel&) = delete;
+    DatagramChannel& operator=(const DatagramChannel&) = delete;
+
+    // Bind to a local endpoint (port 0 picks a free port); returns false on failure.
+    // open() and close() must run on the strand or while no thread runs the io_context.
+    bool open(const Endpoint& local);
+    void close();
+    bool isOpen() const;
+    uint16_t getLocalPort() const;
+
+    // Start the receive loop, malformed datagrams are dropped before reaching the handler
+    void startReceive(ReceiveHandler handler);
+
+    // Queue a datagram for the endpoint; safe to call from any thread
+    void send(const Endpoint& to, Datagram datagram);
+
+    // Sequence number and message as one datagram
+    static Datagram encode(uint32_t sequence, const NetworkMessage& message);
+    // Same, written into out: the header first, then the caller appends the data
+    // and endEncode() fills in its length (payloads are serialized in place)
+    static void beginEncode(std::vector<uint8_t>& out, uint32_t sequence, MessageType type, uint16_t senderId);
+    static void endEncode(std::vector<uint8_t>& out);
+
+    // True if sequence a is newer than b, tolerating wrap-around
+    static bool isNewer(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b) > 0;
+    }
+
+private:
+    void receive();
+
+    boost::asio::ip::udp::socket socket_;
+    ReceiveHandler handler_;
+    std::vector<uint8_t> receiveBuffer_;  // Strand only
+    Endpoint receiveFrom_;                // Strand only
+};
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "NetworkMessage.h"
-#include "network/DeltaState.h"
+#include "network/NetworkConfig.h"
+#include "network/ClientConnection.h"
+#include "network/DatagramChannel.h"
+#include "network/OutboundBundler.h"
+#include "network/WorldSnapshot.h"
 #include <map>
 #include <memory>
 #include <string>
@@ -10,6 +14,7 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS
@@ -17,6 +22,14 @@
 
 #include "interfaces/playerInput.h"
 #include "level_manager.h"
+#include "utils/TickScheduler.h"
+#include "utils/LoadController.h"
+#include "utils/TickProfiler.h"
+#include "utils/MpscQueue.h"
+#include "utils/TripleBuffer.h"
+#include "utils/BufferPool.h"
+#include "utils/FramePool.h"
+#include "utils/TickArena.h"
 // Forward declarations
 class Object;
 class Player;
@@ -30,7 +43,9 @@ class CollisionManager;
  */
 class EmbeddedServer {
 public:
-    EmbeddedServer(int port, const std::filesystem::path& basePath);
+    // parallelLevelUpdate ticks the active levels on a worker pool once more than one is
+    // active. The single-player server only ever runs one level and leaves it off.
+    EmbeddedServer(int port, const std::filesystem::path& basePath, bool parallelLevelUpdate = false);
     ~EmbeddedServer();
     
     // Start the server
@@ -44,9 +59,34 @@ public:
     
     // Check if the server is running
     bool isRunning() const;
+
+    // Number of threads running the io_context (call before start())
+    void setIoThreadCount(size_t count);
+
+    // When disabled the server does not listen on its port and only serves
+    // clients handed over with adoptClient() (call before start())
+    void setAcceptConnections(bool accept);
+
+    // Take over a client connection accepted elsewhere (e.g. by the LobbyRouter).
+    // The socket must belong to getIoContext(), ideally on its own strand.
+    // Safe to call from any thread; returns false if the server is not running.
+    bool adoptClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+    boost::asio::io_context& getIoContext();
+
+    // Number of connected clients
+    size_t getClientCount();
+
+    // Tick scheduler statistics (overruns, skipped ticks, measured tick rate)
+    TickScheduler::Stats getTickStats() const;
+
+    // Per-phase tick timings (p50/p99/max per TickPhase)
+    const TickProfiler& getTickProfiler() const;
+
+    // Decisions of the adaptive load controller (snapshot interval, entity thinning)
+    LoadController::Metrics getLoadMetrics() const;
     
-    // Add a player to the server
-    void addPlayer(const uint16_t playerId);
+    // Add a player to the server, joining the given level (default level when empty)
+    void addPlayer(const uint16_t playerId, const std::string& levelId = "");
     
     // Send a player to the client
     void sendPlayerToClient(const uint16_t playerId, Player* player);
@@ -54,8 +94,8 @@ public:
     // Remove a player from the server
     void removePlayer(const uint16_t playerId);
     
-    // Process incoming network message
-    void processMessage(const NetworkMessage& message);
+    // Process incoming network message (gameplay messages are queued for the game loop)
+    void processMessage(NetworkMessage message);
     
     // Set callback for when a message needs to be sent to clients
     void setMessageCallback(std::function<void(const NetworkMessage&)> callback);
@@ -65,39 +105,82 @@ private:
     void startAccept();
     void handleAccept(const boost::system::error_code& error, std::shared_ptr<boost::asio::ip::tcp::socket> socket);
     void handleClientConnection(std::shared_ptr<boost::asio::ip::tcp::socket> socket);
-    void handleRead(std::shared_ptr<boost::asio::ip::tcp::socket> socket, 
-                    const boost::system::error_code& error, 
-                    size_t bytes_transferred);
-    bool sendToClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket, 
-                     const NetworkMessage& message);
-    // Deserialize message from binary data
-    NetworkMessage deserializeMessage(const std::vector<uint8_t>& data, const uint16_t clientId);
+    // Read chain for one client, runs on the client's strand
+    struct ReadState;
+    void handleRead(std::shared_ptr<boost::asio::ip::tcp::socket> socket, uint16_t playerId,
+                    std::shared_ptr<ReadState> state);
+    void handleReadError(uint16_t playerId, const boost::system::error_code& error);
+    // UDP side channel: offer it over TCP, then take handshakes and input datagrams
+    void offerUdpChannel(const std::shared_ptr<ClientConnection>& connection);
+    void handleDatagram(const DatagramChannel::Endpoint& from, uint32_t sequence,
+                        const uint8_t* body, size_t size);
+    // Sends right away, or stages the message in the bundler if one is given
+    bool sendToClient(const std::shared_ptr<ClientConnection>& connection, 
+                     const NetworkMessage& message, OutboundBundler* bundler = nullptr);
+    // Header and body of a message as one wire frame, in a buffer from the pool if given
+    static ClientConnection::Frame encodeFrame(const NetworkMessage& message, FramePool* pool = nullptr);
+    // Same, written into frame: the header first, then the caller appends the data
+    // and endFrame() fills in the sizes (payloads are serialized in place)
+    static void beginFrame(std::vector<uint8_t>& frame, MessageType type, uint16_t senderId);
+    static void endFrame(std::vector<uint8_t>& frame);
+    // Bytes waiting in the send queues of all clients
+    size_t getQueuedOutboundBytes();
+    // Deserialize message from binary data, the payload goes into a pooled buffer
+    NetworkMessage deserializeMessage(const uint8_t* data, size_t size, const uint16_t clientId);
     void serializeObject(const std::shared_ptr<Object>& object, std::vector<uint8_t>& data);
+    void serializeObject(const ObjectSnapshot& object, std::vector<uint8_t>& data);
+
+    // Apply messages queued by processMessage, called by the game loop
+    void applyQueuedMessages();
+    void applyMessage(const NetworkMessage& message);
 
     // Game logic methods
     void createInitialGameObjects();
     void updateGameState(float deltaTime);
+    // Blocks the game loop while no client is connected; returns true if it parked
+    bool waitWhileIdle();
     void detectAndResolveCollisions();
-    void sendGameStateToClients();
-    void sendFullGameStateToClient(const uint16_t playerId);
-    void sendPartialGameState(const std::vector<std::shared_ptr<Object>>& objects, 
-                              size_t startIndex, size_t count, 
-                              bool isFirstPacket, bool isLastPacket);
-    void sendPartialGameStateToClient(const std::vector<std::shared_ptr<Object>>& objects, 
-                                     size_t startIndex, size_t count, 
-                                     bool isFirstPacket, bool isLastPacket,
-                                     uint16_t playerId);
+
+    // Snapshot hand-off between the game loop and the sender thread
+    void publishSnapshot();
+    // Game loop: adds clients whose dropped state has drained to the pending full states
+    // and forgets the ones that disconnected
+    void updatePendingFullStates();
+    void senderLoop();
+    // Sends the full state captured for joining and resyncing clients
+    void serveFullStateRequests(const WorldSnapshot& snapshot);
+
+    void sendGameStateToClients(const WorldSnapshot& snapshot);
+    void sendFullGameStateToClient(const LevelSnapshot& level, const uint16_t playerId);
+    // Delta over the reliable channel, an empty one is not sent
+    void sendDeltaOverTcp(const ObjectSnapshotRefs& objectsToSend, const ClientIds& recipients);
+    // Every non-tile object of the level as self-contained datagrams, so losing one costs nothing
+    void sendUdpSnapshot(const LevelSnapshot& level, uint32_t sequence,
+                         const std::pmr::vector<DatagramChannel::Endpoint>& endpoints);
     
     // Helper methods for game state updates
-    std::vector<std::shared_ptr<Object>> collectObjectsToSend(const std::vector<std::shared_ptr<Object>>& allObjects);
-    size_t calculateMessageSize(const std::vector<std::shared_ptr<Object>>& objectsToSend);
-    void sendSplitGameState(const std::vector<std::shared_ptr<Object>>& objectsToSend, size_t estimatedSize);
-    void sendSplitGameStateToClient(const std::vector<std::shared_ptr<Object>>& objectsToSend, 
-                                   size_t estimatedSize, uint16_t playerId);
-    void sendSingleGameStatePacket(const std::vector<std::shared_ptr<Object>>& objectsToSend);
-    void sendSingleGameStatePacketToClient(const std::vector<std::shared_ptr<Object>>& objectsToSend, 
+    // The objects of the level that changed since the previous snapshot;
+    // true when the level has objects but none changed, so a heartbeat is due
+    bool collectObjectsToSend(const LevelSnapshot& level, ObjectSnapshotRefs& objectsToSend);
+    void sendSingleGameStatePacket(const ObjectSnapshotRefs& objectsToSend, const ClientIds& recipients);
+    // Sends the tileset table first, the state's tiles refer to it
+    void sendSingleGameStatePacketToClient(const ObjectSnapshotRefs& objectsToSend,
+                                          const std::vector<std::string>& tilesetNames,
                                           uint16_t playerId);
-    void sendMinimalHeartbeat();
+    void sendMinimalHeartbeat(const ClientIds& recipients);
+
+    // Connected clients whose player is in the level, the list allocated from memory
+    ClientIds clientsInLevel(const Level* level,
+                             std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    // Send a message to the listed clients; it is framed once and the frame is shared.
+    // State and heartbeat frames may be dropped for clients that fall behind.
+    // With a bundler the frame is staged and goes out with the producer's next flush.
+    void broadcastToClients(const NetworkMessage& message, const ClientIds& recipients,
+                            OutboundBundler* bundler,
+                            ClientConnection::FrameKind kind = ClientConnection::FrameKind::Reliable);
+    void broadcastFrame(const ClientConnection::Frame& frame, const ClientIds& recipients,
+                        OutboundBundler* bundler,
+                        ClientConnection::FrameKind kind = ClientConnection::FrameKind::Reliable);
     
     // Process player input message
     void processPlayerInput(const uint16_t playerId, const NetworkMessage& message);
@@ -105,7 +188,7 @@ private:
     void processEnemyState(const uint16_t playerId, const NetworkMessage& message);
     
     // Send info messages
-    void sendEnemyStateToClients(const uint16_t enemyId, bool isDead, int16_t health);
+    void sendEnemyStateToClients(const uint16_t enemyId, bool isDead, int16_t health, const Level* level);
 
     // Server configuration
     int port_;
@@ -114,10 +197,19 @@ private:
     
     // Network components
     boost::asio::io_context io_context_;
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+    std::unique_ptr<WorkGuard> workGuard_;  // Keeps the io_context running between client connections
     std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
-    std::unique_ptr<std::thread> io_thread_;
-    std::map<uint16_t, std::shared_ptr<boost::asio::ip::tcp::socket>> clientSockets_;
+    std::vector<std::thread> ioThreads_;
+    size_t ioThreadCount_ = NetworkConfig::Server::IoThreads;
+    bool acceptConnections_ = true;
+    // Unreliable channel for snapshots and input, null if the port could not be bound
+    std::unique_ptr<DatagramChannel> udpChannel_;
+    // Sockets are bound to their own strand; all operations on them are posted there.
+    // The map itself is only read or modified under clientSocketsMutex_.
+    std::map<uint16_t, std::shared_ptr<ClientConnection>> clientSockets_;
     std::mutex clientSocketsMutex_;
+    std::condition_variable clientsChanged_;  // Signalled when a client is added or the server stops
     
     // Game state data
     //std::vector<std::shared_ptr<Object>> gameObjects_;
@@ -127,24 +219,47 @@ private:
     
     // Thread management
     std::unique_ptr<std::thread> gameLoopThread_;
-    std::mutex gameStateMutex_;
+    std::mutex gameStateMutex_;  // Only guards setup/teardown, the game loop owns the game state
+
+    // Gameplay messages from the network thread, drained at the start of every tick.
+    // Their payloads come from receivePool_ and go back to it once applied.
+    MpscQueue<NetworkMessage> inputQueue_;
+    BufferPool receivePool_;
+
+    // World snapshots published by the game loop and serialized by the sender thread,
+    // so delta tracking, serialization and socket fan-out stay off the tick
+    TripleBuffer<WorldSnapshot> snapshots_;
+    uint64_t snapshotTick_ = 0;
+    bool snapshotDropped_ = false;  // The sender skipped the last publish, see publishSnapshot
+    std::unique_ptr<std::thread> senderThread_;
+    std::atomic<bool> senderRunning_{false};
+    std::mutex senderMutex_;
+    std::condition_variable snapshotReady_;
+    bool snapshotPending_ = false;  // Guarded by senderMutex_
+    // Players that joined or fell behind and still need the full state of their level.
+    // Game loop only, the next snapshot of their level carries it to the sender thread.
+    std::vector<uint16_t> pendingFullStates_;
+
+    // Scratch lists and frames of each producing thread. Arenas are reset once the
+    // thread's tick or snapshot went out; frames return to their pool once sent.
+    TickArena tickArena_;        // Game loop only
+    TickArena snapshotArena_;    // Sender thread only
+    FramePool tickFrames_;       // Game loop only
+    FramePool snapshotFrames_;   // Sender thread only
+
+    // Messages for each client are bundled per tick, one bundler per producing thread
+    OutboundBundler tickBundler_{&tickFrames_};          // Game loop only, flushed every tick
+    OutboundBundler snapshotBundler_{&snapshotFrames_};  // Sender thread only, flushed after every snapshot
     
     // Callback for sending messages to clients
     std::function<void(const NetworkMessage&)> messageCallback_;
 
-    // buffers for outgoing messages
 private:
-    std::mutex outgoing_buffers_mutex_;
-    std::vector<std::shared_ptr<std::vector<uint8_t>>> outgoing_buffers_;
-    
-    // Last update time for delta calculation
-    std::chrono::time_point<std::chrono::high_resolution_clock> lastUpdateTime_;
-    
-    // Delta state tracking
-    DeltaStateTracker deltaTracker_;
-    
-    // Maximum game state packet size (to avoid overflow)
-    static constexpr size_t MAX_GAMESTATE_PACKET_SIZE = 1024 * 4; // 4 KB
+    // Fixed-timestep scheduling for the game loop
+    TickScheduler tickScheduler_;
+    float stateUpdateTimer_ = 0.0f;  // Time since the last published snapshot
+    LoadController loadController_;
+    TickProfiler tickProfiler_;
 };
 
 
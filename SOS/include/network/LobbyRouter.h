@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/asio.hpp>
+
+#include "network/EmbeddedServer.h"
+#include "network/NetworkConfig.h"
+
+/**
+ * Front-end acceptor for the dedicated server. Owns the public port and a
+ * pool of in-process EmbeddedServer sessions that do not listen themselves.
+ * Every new connection is accepted straight into the io_context of a session
+ * with a free player slot and handed over to it. Sessions are added ahead of
+ * demand, up to NetworkConfig::Server::LobbyMaxSessions: once only one free
+ * slot is left, the next session starts (and loads its level) on a separate
+ * thread so the accept thread never waits for it. Sessions share nothing: each
+ * has its own players and object ID space (see LevelManager) and its own game
+ * loop. A session whose players are spread over several levels ticks them on
+ * a worker pool.
+ */
+class LobbyRouter {
+public:
+    LobbyRouter(int port, const std::filesystem::path& basePath);
+    ~LobbyRouter();
+
+    // Start listening and the initial sessions
+    void start();
+
+    // Stop accepting and shut down every session
+    void stop();
+
+    bool isRunning() const;
+
+    // Network threads per session (call before start())
+    void setSessionIoThreadCount(size_t count);
+
+    size_t getSessionCount();
+
+private:
+    void startAccept();
+    // Session the next connection goes to, or nullptr when every session is full
+    EmbeddedServer* selectSession();
+    // Create and start a session, null if it failed to start. Takes no lock.
+    std::unique_ptr<EmbeddedServer> createSession();
+    // Start another session on the spawn thread unless one is starting already
+    // or the limit is reached (sessionsMutex_ held)
+    void spawnSession();
+
+    int port_;
+    std::filesystem::path basePath_;
+    std::atomic<bool> running_;
+    size_t sessionIoThreadCount_ = NetworkConfig::Server::LobbySessionIoThreads;
+
+    boost::asio::io_context io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::thread acceptThread_;
+    // While every session is full, new connections wait in the listen backlog
+    // and the router checks for a free slot again when this timer fires
+    boost::asio::steady_timer retryTimer_;
+    bool holdingConnections_ = false;  // Accept thread only
+
+    std::vector<std::unique_ptr<EmbeddedServer>> sessions_;
+    std::mutex sessionsMutex_;
+    std::thread spawnThread_;
+    bool spawning_ = false;  // sessionsMutex_
+};
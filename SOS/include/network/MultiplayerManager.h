@@ -3,6 +3,7 @@
 #include "NetworkInterface.h"
 #include "object.h" // Fixed case sensitivity issue
 #include "objects/player.h"
+#include "network/WorldSnapshot.h"
 #include <memory>
 #include <string>
 #include <map>
@@ -18,8 +19,10 @@ public:
     MultiplayerManager();
     ~MultiplayerManager();
 
-    // Initialize the multiplayer system
-    bool initialize(const std::string& serverAddress, int serverPort, const uint16_t playerId);
+    // Initialize the multiplayer system. levelId picks the level to join, empty joins
+    // the server's default level.
+    bool initialize(const std::string& serverAddress, int serverPort, const uint16_t playerId,
+                    const std::string& levelId = "");
     
     // Shutdown multiplayer system
     void shutdown();
@@ -63,9 +66,6 @@ public:
     
     // Process delta game state update (only changed objects)
     void processGameStateDelta(const std::vector<uint8_t>& gameStateData);
-    
-    // Process part of a multi-packet game state update
-    void processGameStatePart(const std::vector<uint8_t>& gameStateData);
 
 private:
     // Handle network messages received from the server
@@ -87,8 +87,22 @@ private:
     std::vector<uint8_t> serializePlayerState(const Player* player);
     void deserializePlayerState(const std::vector<uint8_t>& data, Player* player);
 
-    // Deserialize object from game state data
+    // Deserialize one WireSchema object record (PLAYER_JOINED)
     std::shared_ptr<Object> deserializeObject(const std::vector<uint8_t>& data, size_t& pos);
+    // Update or create the object a record describes; returns it, or null for unknown types
+    std::shared_ptr<Object> applyObjectRecord(const ObjectSnapshot& record);
+    std::vector<ObjectSnapshot> decodedObjects_;  // Reused for every decoded game state
+
+    // The level's tileset table, tiles in game states refer to it by index
+    struct TilesetEntry {
+        std::string name;
+        SpriteData* spriteSheet = nullptr;  // Stays null when headless
+        bool resolved = false;
+    };
+    void handleTilesetTableMessage(const NetworkMessage& message);
+    // Null for indices the table does not have
+    const TilesetEntry* resolveTileset(uint16_t index);
+    std::vector<TilesetEntry> tilesets_;
     
     // Serialize player input
     std::vector<uint8_t> serializePlayerInput(const PlayerInput* input);
@@ -120,14 +134,4 @@ private:
 
     //Base path for atlas
     std::filesystem::path atlasBasePath_;
-
-    // Multi-part game state handling
-    struct PartialGameState {
-        uint16_t totalObjectCount;
-        bool complete;
-        std::vector<std::vector<uint8_t>> parts;
-        std::vector<uint16_t> packetIndices;
-        std::chrono::steady_clock::time_point lastUpdateTime;
-    };
-    std::unique_ptr<PartialGameState> partialGameState_;
 };
\ No newline at end of file
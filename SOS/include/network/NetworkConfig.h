@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 
@@ -11,21 +12,66 @@ namespace NetworkConfig
         
         constexpr float PositionErrorThreshold = 5.0f; // Small threshold to ignore minor pixel differences
         constexpr float ReconciliationBlendFactor = 0.5f; // Blend factor for reconciliation (0-1)
+
+        constexpr bool UseUdpChannel = true; // Accept the server's UDP offer for snapshots and input
+        constexpr int UdpHelloInterval = 250; // Milliseconds between UDP handshake attempts
+        constexpr int UdpHelloAttempts = 8; // Attempts before staying on TCP only
+        constexpr bool RequestCompressedState = true; // Ask for the full game state on join to be compressed
     }
 
     namespace Server {
         constexpr int TickRate = 60; // 60 ticks per second
+        constexpr int MaxCatchUpTicks = 5; // Late ticks replayed back-to-back before the rest are skipped
+        constexpr int TickStatsReportInterval = 10; // Seconds between tick statistics log lines
+        constexpr int IoThreads = 2; // Threads running the network io_context
+        constexpr int LevelWorkerThreads = 0; // Threads ticking levels in parallel, 0 = one per extra hardware thread
 
         constexpr uint64_t StateUpdateInterval = 20; // 50 updates per second
 
+        // Adaptive load control, see LoadController
+        constexpr int LoadEvaluationTicks = 30; // Ticks per evaluation window
+        constexpr double LoadHighUtilization = 0.75; // Mean tick work / tick period that sheds load
+        constexpr double LoadLowUtilization = 0.40; // Below this the window counts as calm
+        constexpr size_t LoadHighOutboundBytes = 256 * 1024; // Queued client bytes that shed load
+        constexpr size_t LoadLowOutboundBytes = 32 * 1024; // Below this the window counts as calm
+        constexpr int LoadRecoveryWindows = 4; // Calm windows in a row before restoring one level
+        constexpr float DistantEntityRange = 800.0f; // Entities further than this from every player may be thinned
+
+        constexpr int LobbyInitialSessions = 1; // Sessions the lobby router starts with
+        constexpr int LobbyMaxSessions = 16; // Upper bound on sessions behind one lobby port
+        constexpr int LobbySessionIoThreads = 1; // Network threads per lobby session, the sessions already run side by side
+        constexpr int LobbyFullRetryInterval = 500; // Milliseconds between slot checks while every session is full
+        constexpr int LobbySpawnRetryInterval = 20; // Milliseconds between slot checks while a new session is starting
+
+        // Per-client send queue bounds, see ClientConnection
+        constexpr size_t ClientSendHighWaterBytes = 256 * 1024; // Above this, state deltas are dropped for a later resync
+        constexpr size_t ClientSendLowWaterBytes = 64 * 1024; // Below this, a client that missed state gets the full state
+        constexpr size_t ClientSendBacklogLimitBytes = 8 * 1024 * 1024; // Queued bytes that disconnect the client
+
+        constexpr size_t MaxBundleBytes = 16 * 1024; // Messages sent to a client in one tick are bundled up to this size, larger ones go alone
+
+        constexpr size_t CompressStateMinBytes = 4 * 1024; // Smaller full states are not worth compressing
+
+        constexpr int UdpPort = 0; // UDP side channel port, 0 = any free port (advertised to clients over TCP)
+
         // Other settings can be added here like gravity or max velocity
     }
 
     //Shared settings
     constexpr int MaxPlayers = 4; // Maximum number of players in the game
-    constexpr int MaxMessageSize = 1024; // Maximum size of a network message
+    constexpr uint32_t MaxFrameSize = 16 * 1024 * 1024; // Sanity limit for one server to client TCP frame (full game state)
+    // Client to server frames only carry input, positions and chat. The server checks the
+    // length prefix against this before allocating, so a peer cannot make it reserve more.
+    constexpr uint32_t MaxClientFrameSize = 1024;
     constexpr int MaxChatMessageSize = 256; // Maximum size of a chat message
+    static_assert(MaxChatMessageSize + 16 <= MaxClientFrameSize, "a chat message and its message header must fit in a client frame");
+    constexpr size_t MaxDatagramSize = 1200; // Largest UDP datagram, stays below common path MTUs
     constexpr int MaxObjectCount = 100; // Maximum number of game objects in the world
 
+    // Snapshot quantization, see SnapshotCodec
+    constexpr int SnapshotPositionFractionBits = 3; // Positions are sent in 1/8 pixel steps
+    constexpr int SnapshotVelocityFractionBits = 2; // Velocities are sent in 1/4 pixel per second steps
+    constexpr int SnapshotVelocityBits = 12; // Signed velocity width, +-512 pixels per second with 1/4 steps
+
     constexpr int DefaultServerPort = 8282;
 }
\ No newline at end of file
@@ -10,7 +10,6 @@ enum class MessageType {
     PLAYER_INPUT,      // Player input state (new type for server-controlled physics)
     GAME_STATE,        // Complete or partial game state update
     GAME_STATE_DELTA,  // Delta game state update (only changed objects)
-    GAME_STATE_PART,   // Part of a multi-packet game state update
     CHAT_MESSAGE,      // Text chat
     CONNECT,           // Player connected
     DISCONNECT,        // Player disconnected
@@ -20,8 +19,19 @@ enum class MessageType {
     CHAT,            // Chat message
     ENEMY_STATE_UPDATE, // Update enemy state (e.g., health, dead)
     PLAYER_ASSIGN,     // Assign a player to a client
+    UDP_OFFER,         // Server -> client over TCP: [u16 BE port][u32 BE token] of the UDP side channel
+    UDP_HELLO,         // Handshake datagram carrying the token, echoed back by the server
+    UDP_READY,         // Client -> server over TCP: echo received, snapshots may use UDP
+    BUNDLE,            // Server -> client: several messages of one tick, each as [type u8][sender u16 BE][data length u32 BE][data]
+    GAME_STATE_COMPRESSED, // GAME_STATE as [u32 BE original size][LzCodec block], for clients that asked for it
+    TILESET_TABLE,     // Server -> client before every full state: the level's tileset names, tiles refer to them by index
 };
 
+// Optional features a client asks for in its CONNECT message
+namespace ConnectFlags {
+    constexpr uint8_t CompressedState = 0x01; // Full game state may arrive as GAME_STATE_COMPRESSED
+}
+
 // Base message structure - same as client side
 struct NetworkMessage {
     MessageType type;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "network/ClientConnection.h"
+#include "utils/FramePool.h"
+
+/**
+ * Collects the frames one producer (game loop or sender thread) emits for
+ * each client during a tick and sends them as a single BUNDLE frame per
+ * client on flush(). Each bundled message keeps its own body header but the
+ * per-frame size prefix, queue slot and write are shared. Clients that were
+ * staged the exact same frames get the same bundle, so broadcasts are still
+ * framed once. A client with only one staged frame gets that frame as is.
+ * Reliable frames never share a bundle with state or heartbeat frames: a
+ * bundle is reliable if any part is, and the connection could then not
+ * replace its state latest-only for a slow client. Each run of staged frames
+ * of either sort becomes its own bundle, in the order they were staged.
+ * Bundles are built in buffers from the producer's frame pool, if given.
+ * Not thread safe: every producing thread owns its own bundler.
+ *
+ * Bundle data: [type u8][sender u16 BE][data length u32 BE][data] repeated
+ */
+class OutboundBundler {
+public:
+    using Frame = ClientConnection::Frame;
+    using FrameKind = ClientConnection::FrameKind;
+
+    explicit OutboundBundler(FramePool* framePool = nullptr) : framePool_(framePool) {}
+
+    // Pool of the producing thread, null if it has none
+    FramePool* framePool() const { return framePool_; }
+
+    // Stage a frame for the client; frames too large to be worth bundling
+    // are sent right away, after whatever is already staged for the client
+    void add(const std::shared_ptr<ClientConnection>& connection, const Frame& frame, FrameKind kind);
+
+    // Send everything staged since the last flush
+    void flush();
+
+private:
+    struct Item {
+        Frame frame;
+        FrameKind kind;
+    };
+    struct Pending {
+        std::shared_ptr<ClientConnection> connection;
+        std::vector<Item> items;
+        size_t bytes = 0;
+    };
+
+    // Bundle built during the current flush, for clients staged the same frames
+    struct Built {
+        const Item* items;
+        size_t count;
+        Frame bundle;
+    };
+
+    Pending& pendingFor(const std::shared_ptr<ClientConnection>& connection);
+    // Send the staged items run by run, see the class comment; the items stay staged.
+    // shareBundles reuses and records bundles in built_, only valid during flush().
+    void sendRuns(Pending& pending, bool shareBundles);
+    void sendRun(const std::shared_ptr<ClientConnection>& connection, const Item* items, size_t count,
+                 size_t bytes, bool shareBundles);
+    // Bundle kind: reliable if any item is, state if any item is, else heartbeat
+    static FrameKind bundleKind(const Item* items, size_t count);
+    Frame encodeBundle(const Item* items, size_t count, size_t bytes);
+
+    FramePool* framePool_;
+    std::vector<Pending> pending_;  // Entries are kept between ticks for their allocations
+    size_t pendingCount_ = 0;
+    std::vector<Built> built_;
+};
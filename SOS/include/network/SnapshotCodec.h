@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "network/WorldSnapshot.h"
+
+/**
+ * Bit-packed encoding of the object lists in GAME_STATE and GAME_STATE_DELTA.
+ * Positions are quantized to fixed point (NetworkConfig::SnapshotPositionFractionBits)
+ * relative to a frame spanning the objects of the payload, i.e. the part of the level
+ * they cover, so each axis only takes as many bits as that span needs. Velocities
+ * are quantized to a small signed range and objects at rest carry a single bit.
+ * Ids and counts are varints.
+ *
+ * Payload: [count varint] and, if count > 0, [origin x, y zigzag varint][bits x, y u6]
+ * followed by the objects, padded to a whole byte. Object:
+ *   [type u3][id varint][x, y offset][moving u1]([velocity x, y])
+ *   PLAYER, MINOTAUR: [animState u4][direction u3][health zigzag varint]
+ *   TILE:             [tileIndex u8][flags varint][tileset varint]
+ */
+class SnapshotCodec {
+public:
+    // Quantized area the positions of one payload are relative to
+    struct Frame {
+        int32_t originX = 0;
+        int32_t originY = 0;
+        uint8_t bitsX = 0;
+        uint8_t bitsY = 0;
+    };
+
+    // Smallest frame holding every object
+    static Frame frameFor(const ObjectSnapshot* const* objects, size_t count);
+
+    // Append the payload for the objects to out, e.g. after a frame header
+    static void encode(const ObjectSnapshotRefs& objects, std::vector<uint8_t>& out);
+    // Same with a given frame, which must hold every object (for payloads split into parts)
+    static void encode(const ObjectSnapshot* const* objects, size_t count, const Frame& frame, std::vector<uint8_t>& out);
+
+    // Encoded size of the payload header and of one object, in bits
+    static size_t headerBits(size_t count, const Frame& frame);
+    static size_t objectBits(const ObjectSnapshot& object, const Frame& frame);
+
+    // Replace objects with the decoded ones; returns false if the payload is malformed
+    static bool decode(const uint8_t* data, size_t size, std::vector<ObjectSnapshot>& objects);
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "object.h"
+#include "network/WorldSnapshot.h"
+
+/**
+ * Wire layout of the records the server and the client exchange, defined
+ * once for both sides. Every record is described by a single visit function
+ * listing its fields in wire order; Sizer, Writer and Reader walk that same
+ * list, so the encoder, the decoder and the size calculation cannot drift
+ * apart. All multi-byte fields are little-endian. Writers expect a buffer
+ * presized with Sizer and store each field with one fixed-size memcpy.
+ *
+ * Object record: [type u8][id u16][position f32 x2][velocity f32 x2] followed by
+ *   PLAYER, MINOTAUR: [animState u8][direction u8][health i16]
+ *   TILE:             [tileIndex u8][flags u32][tileset u16]
+ * Tileset table: [count u16] then [name length u8][name] per tileset
+ */
+namespace WireSchema {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool HostIsLittleEndian = false;
+#else
+constexpr bool HostIsLittleEndian = true;
+#endif
+
+// Longest tileset name the tileset table can carry
+constexpr size_t MaxNameLength = 255;
+
+template <typename T>
+inline void storeLittleEndian(uint8_t* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+    if (!HostIsLittleEndian) {
+        std::reverse(out, out + sizeof(T));
+    }
+}
+
+template <typename T>
+inline T loadLittleEndian(const uint8_t* in) {
+    T value;
+    if (HostIsLittleEndian) {
+        std::memcpy(&value, in, sizeof(T));
+    } else {
+        uint8_t bytes[sizeof(T)];
+        std::reverse_copy(in, in + sizeof(T), bytes);
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+    return value;
+}
+
+// Adds up the encoded size of the visited fields
+class Sizer {
+public:
+    template <typename T>
+    void field(const T&) { size_ += sizeof(T); }
+    void name(const std::string& value) {
+        size_ += 1 + std::min(value.size(), MaxNameLength);
+    }
+    size_t size() const { return size_; }
+
+private:
+    size_t size_ = 0;
+};
+
+// Writes the visited fields into a buffer that Sizer said is large enough
+class Writer {
+public:
+    explicit Writer(uint8_t* out) : out_(out) {}
+
+    template <typename T>
+    void field(const T& value) {
+        storeLittleEndian(out_, value);
+        out_ += sizeof(T);
+    }
+    void name(const std::string& value) {
+        const size_t length = std::min(value.size(), MaxNameLength);
+        *out_++ = static_cast<uint8_t>(length);
+        if (length > 0) {
+            std::memcpy(out_, value.data(), length);
+            out_ += length;
+        }
+    }
+    uint8_t* position() const { return out_; }
+
+private:
+    uint8_t* out_;
+};
+
+// Reads the visited fields; once a field does not fit, ok() turns false and the rest is skipped
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size, size_t pos)
+        : data_(data), size_(size), pos_(pos) {}
+
+    template <typename T>
+    void field(T& value) {
+        if (!ok_ || size_ - pos_ < sizeof(T)) {
+            ok_ = false;
+            return;
+        }
+        value = loadLittleEndian<T>(data_ + pos_);
+        pos_ += sizeof(T);
+    }
+    void name(std::string& value) {
+        uint8_t length = 0;
+        field(length);
+        if (!ok_ || size_ - pos_ < length) {
+            ok_ = false;
+            return;
+        }
+        value.assign(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+    }
+    bool ok() const { return ok_; }
+    size_t position() const { return pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+    bool ok_ = true;
+};
+
+// --- Records -----------------------------------------------------------------
+
+// One replicated object, sent in game states, deltas and PLAYER_JOINED
+template <typename Io, typename Record>
+void visitObject(Io& io, Record& obj) {
+    io.field(obj.type);
+    io.field(obj.id);
+    io.field(obj.position.x);
+    io.field(obj.position.y);
+    io.field(obj.velocity.x);
+    io.field(obj.velocity.y);
+    switch (static_cast<ObjectType>(obj.type)) {
+        case ObjectType::PLAYER:
+        case ObjectType::MINOTAUR:
+            io.field(obj.animState);
+            io.field(obj.direction);
+            io.field(obj.health);
+            break;
+        case ObjectType::TILE:
+            io.field(obj.tileIndex);
+            io.field(obj.flags);
+            io.field(obj.tilesetIndex);
+            break;
+        default:
+            break;
+    }
+}
+
+// PLAYER_POSITION payload, sent by the client for reconciliation
+struct PlayerState {
+    Vec2 position;
+    Vec2 velocity;
+    uint8_t direction = 0;
+    uint8_t animState = 0;
+};
+
+template <typename Io, typename State>
+void visitPlayerState(Io& io, State& state) {
+    io.field(state.position.x);
+    io.field(state.position.y);
+    io.field(state.velocity.x);
+    io.field(state.velocity.y);
+    io.field(state.direction);
+    io.field(state.animState);
+}
+
+// ENEMY_STATE_UPDATE payload, sent both ways
+struct EnemyState {
+    uint16_t enemyId = 0;
+    uint8_t isDead = 0;
+    int16_t health = 0;
+};
+
+template <typename Io, typename State>
+void visitEnemyState(Io& io, State& state) {
+    io.field(state.enemyId);
+    io.field(state.isDead);
+    io.field(state.health);
+}
+
+// --- Helpers -----------------------------------------------------------------
+
+inline size_t encodedSize(const ObjectSnapshot& obj) {
+    Sizer sizer;
+    visitObject(sizer, obj);
+    return sizer.size();
+}
+
+// Writes the record at out, which must hold encodedSize(obj) bytes; returns the end
+inline uint8_t* encode(const ObjectSnapshot& obj, uint8_t* out) {
+    Writer writer(out);
+    visitObject(writer, obj);
+    return writer.position();
+}
+
+inline void append(const ObjectSnapshot& obj, std::vector<uint8_t>& data) {
+    const size_t offset = data.size();
+    data.resize(offset + encodedSize(obj));
+    encode(obj, data.data() + offset);
+}
+
+// Reads the record at pos and advances it; returns false if the record is truncated
+inline bool decode(const uint8_t* data, size_t size, size_t& pos, ObjectSnapshot& obj) {
+    obj = ObjectSnapshot();
+    Reader reader(data, size, pos);
+    visitObject(reader, obj);
+    if (!reader.ok()) {
+        return false;
+    }
+    pos = reader.position();
+    return true;
+}
+
+// Fixed-size records are encoded into a fresh payload and decoded from the start of one
+inline std::vector<uint8_t> encode(const PlayerState& state) {
+    Sizer sizer;
+    visitPlayerState(sizer, state);
+    std::vector<uint8_t> data(sizer.size());
+    Writer writer(data.data());
+    visitPlayerState(writer, state);
+    return data;
+}
+
+inline std::vector<uint8_t> encode(const EnemyState& state) {
+    Sizer sizer;
+    visitEnemyState(sizer, state);
+    std::vector<uint8_t> data(sizer.size());
+    Writer writer(data.data());
+    visitEnemyState(writer, state);
+    return data;
+}
+
+inline bool decode(const std::vector<uint8_t>& data, PlayerState& state) {
+    Reader reader(data.data(), data.size(), 0);
+    visitPlayerState(reader, state);
+    return reader.ok();
+}
+
+inline bool decode(const std::vector<uint8_t>& data, EnemyState& state) {
+    Reader reader(data.data(), data.size(), 0);
+    visitEnemyState(reader, state);
+    return reader.ok();
+}
+
+// TILESET_TABLE payload, sent before every full game state
+inline std::vector<uint8_t> encodeTilesetTable(const std::vector<std::string>& names) {
+    const uint16_t count = static_cast<uint16_t>(std::min<size_t>(names.size(), UINT16_MAX));
+    Sizer sizer;
+    sizer.field(count);
+    for (uint16_t i = 0; i < count; ++i) {
+        sizer.name(names[i]);
+    }
+    std::vector<uint8_t> data(sizer.size());
+    Writer writer(data.data());
+    writer.field(count);
+    for (uint16_t i = 0; i < count; ++i) {
+        writer.name(names[i]);
+    }
+    return data;
+}
+
+inline bool decodeTilesetTable(const std::vector<uint8_t>& data, std::vector<std::string>& names) {
+    Reader reader(data.data(), data.size(), 0);
+    uint16_t count = 0;
+    reader.field(count);
+    names.resize(reader.ok() ? count : 0);
+    for (std::string& name : names) {
+        reader.name(name);
+    }
+    return reader.ok();
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Vec2.h"
+
+// Forward declarations
+class Object;
+class Level;
+
+// Copy of the replicated state of one object, taken on the simulation thread
+struct ObjectSnapshot {
+    uint16_t id = 0;
+    uint8_t type = 0;
+    Vec2 position;
+    Vec2 velocity;
+
+    // PLAYER / MINOTAUR
+    uint8_t animState = 0;
+    uint8_t direction = 0;
+    int16_t health = 0;
+
+    // TILE
+    uint8_t tileIndex = 0;
+    uint32_t flags = 0;
+    uint16_t tilesetIndex = 0; // Into the level's tileset table, see Level::getTilesetNames
+
+    static ObjectSnapshot fromObject(const Object& obj);
+};
+
+// Subset of a level snapshot selected for sending. Both lists are polymorphic so the
+// server can build them in its per-tick arena; default constructed they use the heap.
+using ObjectSnapshotRefs = std::pmr::vector<const ObjectSnapshot*>;
+// Clients a level's state goes to
+using ClientIds = std::pmr::vector<uint16_t>;
+
+// State of one level plus the clients that should receive it
+struct LevelSnapshot {
+    std::string levelId;
+    std::vector<uint16_t> recipients;
+    std::vector<ObjectSnapshot> changed;  // Objects that changed since the previous capture
+    // Every object that is not a tile, for the UDP side channel. Only captured when a
+    // recipient is on it; without it, this snapshot goes to every client over TCP.
+    std::vector<ObjectSnapshot> dynamic;
+    bool dynamicCaptured = false;
+    // Clients that joined or fell behind and get the full state of the level
+    std::vector<uint16_t> fullStateRecipients;
+    // Every object of the level, only captured when there are full state recipients
+    std::vector<ObjectSnapshot> objects;
+    size_t objectCount = 0;
+    // The level's tileset table, sent to clients with the full state
+    std::shared_ptr<const std::vector<std::string>> tilesetNames;
+
+    // Overwrite this snapshot with the level's current state, reusing allocations.
+    // The changes are the objects the level's dirty tracker collected since the
+    // last capture, found by ID without visiting the rest of the level; the
+    // whole level is only copied when a client needs its full state, its moving
+    // objects only when needDynamic is set.
+    void capture(Level& level, const ClientIds& levelRecipients, const ClientIds& fullStateClients,
+                 bool needDynamic);
+};
+
+// Immutable once published; consumed by the server's sender thread
+struct WorldSnapshot {
+    uint64_t tick = 0;
+    std::vector<LevelSnapshot> levels;  // Only the first levelCount entries are valid
+    size_t levelCount = 0;
+};
@@ -8,6 +8,7 @@
 #include "sprite_data.h"
 #include "collision/CollisionVisitor.h"
 #include "animation.h"
+#include "DirtyTracker.h"
 
 
 class Tile;
@@ -48,18 +49,7 @@ BoxCollider(float x, float y, float width, float height);
 
 class Object {
 public:
-        static uint16_t getNextObjectID() {
-            std::lock_guard<std::mutex> lock(countmutex); // Ensure thread-safe access
-            return objectCount++;
-        }
-        static uint16_t getObjectCount() {
-            std::lock_guard<std::mutex> lock(countmutex); // Ensure thread-safe access
-            return objectCount;
-        }
-    private:
-    static uint16_t objectCount; // Static counter to assign unique IDs to objects
-    static std::mutex countmutex; // Mutex to protect access to objectCount
-public:
+    // IDs come from the session's ObjectIdAllocator, see LevelManager::getObjectIds
     const ObjectType type;
     Object(BoxCollider collider, ObjectType type, uint16_t ID);
     virtual ~Object() = default;
@@ -69,6 +59,7 @@ public:
     virtual bool isCollidable() const { return true; } // Default to collidable
     
     void addSpriteSheet(AnimationState state, std::string tpsheet, uint32_t frameTime = 150);
+    void addSpriteSheet(AnimationState state, SpriteData* spriteSheet, uint32_t frameTime = 150);
     const SpriteData* getCurrentSpriteData() const;
 
     // Animation methods
@@ -82,19 +73,53 @@ public:
 
 
     FacingDirection getDir() const { return dir; }
-    void setDir(FacingDirection direction) { dir = direction; }
+    void setDir(FacingDirection direction) {
+        if (dir != direction) {
+            dir = direction;
+            markDirty();
+        }
+    }
 
+    // Replicated state only changes through these setters, so they can report it
     Vec2 getposition() const { return collider.position; }
-    void setposition(const Vec2& pos) { collider.position = pos; }
+    void setposition(const Vec2& pos) {
+        if (pos.x != collider.position.x || pos.y != collider.position.y) {
+            collider.position = pos;
+            markDirty();
+        }
+    }
+    const BoxCollider& getcollider() const { return collider; }
+    void setcollider(const BoxCollider& value) {
+        setposition(value.position);
+        collider.size = value.size;
+    }
+    const Vec2& getvelocity() const { return velocity; }
+    void setvelocity(const Vec2& value) {
+        if (value.x != velocity.x || value.y != velocity.y) {
+            velocity = value;
+            markDirty();
+        }
+    }
+
+    // Changes are reported to the tracker of the level holding the object, if any
+    void setDirtyTracker(DirtyTracker* tracker) { dirtyTracker_ = tracker; }
 
 protected:
+    // Call after changing replicated state other than through the setters above
+    void markDirty() {
+        if (dirtyTracker_) {
+            dirtyTracker_->mark(ObjID);
+        }
+    }
+
     AnimationController animController;
     FacingDirection dir;
     
     
 private:
-    DEFINE_GETTER_SETTER(BoxCollider, collider);
-    DEFINE_GETTER_SETTER(Vec2, velocity);
+    BoxCollider collider;
+    Vec2 velocity;
+    DirtyTracker* dirtyTracker_ = nullptr;
     DEFINE_CONST_GETTER_SETTER(uint16_t, ObjID); // ID of the object, for multiplayer to indicate between players and objects
 };
 
@@ -7,7 +7,7 @@
 class Tile : public Object {
 public:
     Tile(int x, int y, uint16_t objID, std::string tileMap, int tileIndex,
-         int tileWidth, int tileHeight, int columns);
+         int tileWidth, int tileHeight, int columns, uint16_t tilesetIndex = 0);
     // Tile(int ID, int x, int y);
     void update(float deltaTime) override;
     void accept(CollisionVisitor& visitor) override;
@@ -15,14 +15,26 @@ public:
     bool isCollidable() const override;
     
     void setupAnimations(std::filesystem::path atlasPath);
+    // Same with the tileset's sprite sheet already loaded (null when headless)
+    void setupAnimations(SpriteData* spriteSheet);
     
     int getCurrentSpriteIndex() const override {
         return tileIndex;
     }
     
     bool hasFlag(uint32_t flag) const { return (collisionFlags & flag) != 0; }
-    void setFlag(uint32_t flag) { collisionFlags |= flag; }
-    void clearFlag(uint32_t flag) { collisionFlags &= ~flag; }
+    void setFlag(uint32_t flag) {
+        if ((collisionFlags & flag) != flag) {
+            collisionFlags |= flag;
+            markDirty();
+        }
+    }
+    void clearFlag(uint32_t flag) {
+        if ((collisionFlags & flag) != 0) {
+            collisionFlags &= ~flag;
+            markDirty();
+        }
+    }
     uint32_t getFlags() const { return collisionFlags; }
 
     // Collision flags
@@ -39,4 +51,5 @@ private:
     uint32_t collisionFlags = 0;
     DEFINE_CONST_GETTER_SETTER(uint8_t, tileIndex);
     DEFINE_CONST_GETTER_SETTER(std::string, tileMapName);
+    DEFINE_CONST_GETTER_SETTER(uint16_t, tilesetIndex); // Position of tileMapName in the level's tileset table
 };
\ No newline at end of file
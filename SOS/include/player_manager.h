@@ -10,18 +10,17 @@
 #include <mutex>
 #include <iostream>
 /**
- * PlayerManager - Singleton class for managing players across the game
+ * PlayerManager - Players of one game session
  * 
  * This class centralizes player management so they can be accessed
- * from both Level objects and the EmbeddedServer. It ensures that 
- * players are created consistently and can be tracked across the game.
+ * from both the LevelManager and the EmbeddedServer. It ensures that 
+ * players are created consistently and can be tracked across levels.
+ * Every session owns one (see LevelManager::getPlayerManager), so
+ * sessions sharing a process never see each other's players.
  */
 class PlayerManager {
 public:
-    /**
-     * Get the singleton instance
-     */
-    static PlayerManager& getInstance();
+    PlayerManager() = default;
 
     std::shared_ptr<Player> createPlayer(const uint16_t playerId, const Vec2& position = Vec2(500, 100));
 
@@ -37,14 +36,11 @@ public:
     void clear();
 
 
-private:
-    // Private constructor for singleton
-    PlayerManager() {}
-    
     // Prevent copying
     PlayerManager(const PlayerManager&) = delete;
     PlayerManager& operator=(const PlayerManager&) = delete;
-    
+
+private:
     // Player storage
     std::unordered_map<uint16_t, std::shared_ptr<Player>> players_;
     std::mutex playerMutex_;
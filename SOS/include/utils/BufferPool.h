@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Pool of byte buffers that keeps their allocations between uses.
+ * acquire() hands out a buffer resized to the requested length, reusing the
+ * capacity of a released one when available; release() takes it back. Safe
+ * to use from several threads, e.g. filled on the network thread and given
+ * back by the game thread once the message was handled. Buffers that grew
+ * beyond maxRetainedCapacity are freed instead of pooled so one huge message
+ * does not pin its memory forever.
+ */
+class BufferPool {
+public:
+    using Buffer = std::vector<uint8_t>;
+
+    explicit BufferPool(size_t maxPooled = 64, size_t maxRetainedCapacity = 64 * 1024)
+        : maxPooled_(maxPooled),
+          maxRetainedCapacity_(maxRetainedCapacity) {
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    Buffer acquire(size_t size) {
+        Buffer buffer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                buffer = std::move(free_.back());
+                free_.pop_back();
+            }
+        }
+        // Contents are overwritten by the caller, only the length matters
+        buffer.resize(size);
+        return buffer;
+    }
+
+    void release(Buffer&& buffer) {
+        if (buffer.capacity() == 0 || buffer.capacity() > maxRetainedCapacity_) {
+            return;
+        }
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < maxPooled_) {
+            free_.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    const size_t maxPooled_;
+    const size_t maxRetainedCapacity_;
+    std::mutex mutex_;
+    std::vector<Buffer> free_;
+};
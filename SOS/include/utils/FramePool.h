@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Pool of shared byte buffers for outgoing frames and datagrams.
+ * A frame is shared by every connection that sends it and lives until the
+ * last asynchronous write finished, so it cannot come from a per-tick arena.
+ * Instead the pool keeps a reference to every buffer it handed out and
+ * gives one out again once it holds the only reference left; both the
+ * buffer's capacity and its shared_ptr control block are reused. acquire()
+ * is for the one producing thread that owns the pool, the references may
+ * be dropped on any thread. Buffers that grew beyond maxRetainedCapacity
+ * are replaced instead of reused so one huge frame does not pin its memory.
+ */
+class FramePool {
+public:
+    using Buffer = std::shared_ptr<std::vector<uint8_t>>;
+
+    explicit FramePool(size_t maxPooled = 256, size_t maxRetainedCapacity = 64 * 1024)
+        : maxPooled_(maxPooled),
+          maxRetainedCapacity_(maxRetainedCapacity) {
+    }
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // An empty buffer with room for at least capacity bytes
+    Buffer acquire(size_t capacity) {
+        // Round robin, buffers handed out longest ago are the most likely to be back
+        for (size_t scanned = 0; scanned < buffers_.size(); ++scanned) {
+            next_ = (next_ + 1) % buffers_.size();
+            Buffer& buffer = buffers_[next_];
+            if (buffer.use_count() != 1) {
+                continue;
+            }
+            // Pairs with the release of the last other owner, its reads of the bytes are done
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer->capacity() > maxRetainedCapacity_) {
+                buffer = std::make_shared<std::vector<uint8_t>>();
+            }
+            buffer->clear();
+            buffer->reserve(capacity);
+            return buffer;
+        }
+        auto buffer = std::make_shared<std::vector<uint8_t>>();
+        buffer->reserve(capacity);
+        if (buffers_.size() < maxPooled_) {
+            buffers_.push_back(buffer);
+        }
+        return buffer;
+    }
+
+private:
+    const size_t maxPooled_;
+    const size_t maxRetainedCapacity_;
+    std::vector<Buffer> buffers_;
+    size_t next_ = 0;
+};
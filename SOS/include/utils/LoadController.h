@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Adaptive load controller for the server game loop.
+ * Watches how much of each tick period is spent working and how many bytes
+ * are waiting to be written to clients, and steps through a ladder of
+ * degradation levels before the loop starts missing deadlines: first the
+ * snapshot send rate is lowered, then entities far from every player are
+ * simulated less often. Once load has been low for a few evaluation windows
+ * it steps back down one level at a time.
+ */
+class LoadController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Metrics {
+        uint32_t level = 0;                // 0 = full rate
+        uint64_t snapshotIntervalMs = 0;   // Current interval between state snapshots
+        uint32_t distantUpdateStride = 1;  // Distant entities update every Nth tick
+        double tickUtilization = 0.0;      // Mean work time / tick period over the last window
+        double peakTickUtilization = 0.0;  // Highest single tick in the last window
+        uint64_t outboundBytes = 0;        // Bytes queued for clients at the end of the last window
+        uint64_t escalations = 0;          // Times a level was added
+        uint64_t recoveries = 0;           // Times a level was removed
+    };
+
+    LoadController(Clock::duration tickPeriod, uint64_t baseSnapshotIntervalMs);
+
+    // Back to full rate, e.g. after the game loop was idle
+    void reset();
+
+    // Game loop: time spent in the tick and the current outbound backlog
+    void recordTick(Clock::duration workTime, size_t outboundBytes);
+
+    // Game loop: current decisions
+    uint64_t getSnapshotIntervalMs() const;
+    int getDistantUpdateStride() const;
+
+    // Safe to call from any thread
+    Metrics getMetrics() const;
+
+private:
+    struct Step {
+        int snapshotIntervalMultiplier;
+        int distantUpdateStride;
+    };
+    static const Step Steps[];
+    static const uint32_t MaxLevel;
+
+    void evaluateWindow();
+    void setLevel(uint32_t level);
+
+    Clock::duration tickPeriod_;
+    uint64_t baseSnapshotIntervalMs_;
+
+    // Current evaluation window (game loop only)
+    int windowTicks_ = 0;
+    Clock::duration windowWork_{0};
+    Clock::duration windowPeak_{0};
+    size_t windowOutboundBytes_ = 0;
+    int calmWindows_ = 0;
+
+    std::atomic<uint32_t> level_{0};
+    std::atomic<double> tickUtilization_{0.0};
+    std::atomic<double> peakTickUtilization_{0.0};
+    std::atomic<uint64_t> outboundBytes_{0};
+    std::atomic<uint64_t> escalations_{0};
+    std::atomic<uint64_t> recoveries_{0};
+};
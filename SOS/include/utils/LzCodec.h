@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Small LZ77 byte codec using the LZ4 block layout: sequences of literal
+ * runs followed by (offset, length) back-references into the last 64 KB.
+ * Greedy matching on a hash of 4-byte words keeps compression cheap enough
+ * to run per join; serialized level state (thousands of tile records that
+ * differ in a few bytes) shrinks several times. Decompression validates
+ * every length and offset, so corrupt input fails instead of overrunning.
+ */
+class LzCodec {
+public:
+    // Replaces out with the compressed form of the input
+    static void compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+
+    // Decompresses into exactly originalSize bytes at out; false if the input is corrupt
+    static bool decompress(const uint8_t* data, size_t size, uint8_t* out, size_t originalSize);
+
+    // Upper bound of the compressed size of size bytes
+    static size_t maxCompressedSize(size_t size) { return size + size / 255 + 16; }
+};
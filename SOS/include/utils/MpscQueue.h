@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi-producer / single-consumer queue (Vyukov style).
+ * Any thread may push(); only one thread may call tryPop(). Producers never
+ * wait on the consumer and vice versa: a push is one atomic exchange plus a
+ * store. An item whose push is still in flight may be seen on the next pop
+ * instead of the current one, which is fine for per-tick draining.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        T discarded;
+        while (tryPop(discarded)) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only. Returns false when no completed push is available.
+    bool tryPop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        out = std::move(next->value);
+        tail_ = next;  // next becomes the new stub
+        delete tail;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node*> head_{nullptr};  // Producers append here
+    Node* tail_ = nullptr;              // Consumer reads from here
+};
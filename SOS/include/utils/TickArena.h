@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Bump allocator for scratch memory that only lives for one tick.
+ * Allocations take the next bytes of the current block and deallocation
+ * does nothing; reset() at the end of the tick rewinds everything at once.
+ * When a tick needed more than one block, reset() replaces them with a
+ * single block of the combined size, so after the first few ticks a
+ * steady-state tick never touches the heap. Meant for std::pmr containers
+ * (recipient lists, object refs, datagram lists) built while serializing.
+ * Not thread safe: every thread owns its own arena.
+ */
+class TickArena : public std::pmr::memory_resource {
+public:
+    explicit TickArena(size_t initialBytes = 16 * 1024);
+    ~TickArena() override;
+
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+
+    // Release everything allocated since the last reset; no live allocation may remain
+    void reset();
+
+    // Bytes handed out since the last reset and the most any tick needed so far
+    size_t used() const { return used_; }
+    size_t highWater() const { return highWater_; }
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void addBlock(size_t minimumBytes);
+    void releaseBlocks();
+
+    std::vector<Block> blocks_;  // The last one is being bumped
+    size_t offset_ = 0;          // Into the last block
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+};
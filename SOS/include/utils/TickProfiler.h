@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Phases of a server tick that are timed individually
+enum class TickPhase : uint8_t {
+    Tick,               // Whole updateGameState call
+    LevelUpdate,        // LevelManager::update
+    ObjectUpdate,       // Object::update for every level object
+    Collision,          // Level::detectAndResolveCollisions
+    Snapshot,           // Capturing the world snapshot for the sender thread
+    // Sender thread phases, committed once per snapshot pass by commitSenderPass()
+    CollectObjects,     // EmbeddedServer::collectObjectsToSend
+    Serialization,      // Building state message payloads
+    SocketFanout,       // Framing and queueing writes to client sockets
+    Count
+};
+
+/**
+ * Lock-free latency histogram in microseconds.
+ * Buckets are log-linear (8 linear steps per power of two), so reported
+ * percentiles are within 12.5% of the recorded value. Recording only touches
+ * relaxed atomics and can be done from any thread.
+ */
+class LatencyHistogram {
+public:
+    void record(uint64_t micros);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given percentile (0.0 - 1.0)
+    uint64_t percentile(double p) const;
+
+private:
+    static constexpr int SubBucketBits = 3;
+    static constexpr int SubBuckets = 1 << SubBucketBits;
+    static constexpr int MaxExponent = 26; // ~67 seconds
+    static constexpr size_t BucketCount = SubBuckets + (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+    static size_t bucketIndex(uint64_t micros);
+    static uint64_t bucketUpperBound(size_t index);
+
+    std::array<std::atomic<uint64_t>, BucketCount> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * Per-phase tick profiler. Samples recorded during a tick are summed per
+ * phase (levels ticking on several threads add up) and committed to that
+ * phase's histogram by endTick(), so every histogram entry is one tick.
+ * The sender thread's phases run on their own schedule and are committed by
+ * commitSenderPass(), one histogram entry per snapshot pass.
+ */
+class TickProfiler {
+public:
+    struct PhaseStats {
+        uint64_t samples = 0;
+        uint64_t p50Micros = 0;
+        uint64_t p99Micros = 0;
+        uint64_t maxMicros = 0;
+    };
+
+    // RAII timer that records the enclosing scope into a phase.
+    // A null profiler makes it a no-op so callers need no checks.
+    class ScopedPhase {
+    public:
+        ScopedPhase(TickProfiler* profiler, TickPhase phase)
+            : profiler_(profiler), phase_(phase),
+              start_(profiler ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+        ~ScopedPhase() {
+            if (profiler_) {
+                profiler_->record(phase_, std::chrono::steady_clock::now() - start_);
+            }
+        }
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        TickProfiler* profiler_;
+        TickPhase phase_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Add time spent in a phase during the current tick
+    void record(TickPhase phase, std::chrono::steady_clock::duration elapsed);
+
+    // Commit the current tick's game loop phase totals to the histograms
+    void endTick();
+
+    // Commit the sender phase totals of the snapshot pass that just finished
+    void commitSenderPass();
+
+    PhaseStats getPhaseStats(TickPhase phase) const;
+    void reset();
+
+    static const char* phaseName(TickPhase phase);
+
+private:
+    static constexpr size_t PhaseCount = static_cast<size_t>(TickPhase::Count);
+    static constexpr size_t FirstSenderPhase = static_cast<size_t>(TickPhase::CollectObjects);
+
+    void commitPhases(size_t first, size_t last);
+
+    std::array<LatencyHistogram, PhaseCount> histograms_;
+    std::array<std::atomic<uint64_t>, PhaseCount> pendingNanos_{};
+    std::array<std::atomic<bool>, PhaseCount> pendingTouched_{};
+};
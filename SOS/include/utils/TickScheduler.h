@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Fixed-timestep scheduler driven by absolute steady_clock deadlines.
+ * Every tick advances the deadline by exactly one period, so sleep jitter and
+ * tick duration never accumulate into drift. When a tick overruns, the loop
+ * runs up to maxCatchUpTicks back-to-back; anything beyond that is dropped and
+ * counted as skipped instead of bursting through a long backlog.
+ */
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t ticks = 0;          // Ticks executed since start
+        uint64_t overruns = 0;       // Times the loop fell behind; catch-up ticks are not counted again
+        uint64_t skippedTicks = 0;   // Ticks dropped because catch-up was exhausted
+        double measuredTickRate = 0.0; // Ticks per second over the last second
+    };
+
+    TickScheduler(int tickRate, int maxCatchUpTicks);
+
+    // Anchor the schedule to the current time; the next tick is due immediately
+    void reset();
+
+    // Sleep until the next tick is due (returns at once when running behind)
+    void waitForNextTick();
+
+    // Call once a tick has finished to advance the deadline and update stats
+    void endTick();
+
+    // Fixed simulation step in seconds
+    float getFixedDeltaSeconds() const { return fixedDeltaSeconds_; }
+    Clock::duration getPeriod() const { return period_; }
+
+    // Safe to call from any thread
+    Stats getStats() const;
+
+private:
+    Clock::duration period_;
+    float fixedDeltaSeconds_;
+    int maxCatchUpTicks_;
+
+    Clock::time_point nextDeadline_;
+    bool behind_ = false; // Catching up on a deadline that was already missed
+
+    // Tick rate measurement window
+    Clock::time_point windowStart_;
+    uint64_t windowTicks_ = 0;
+
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> skippedTicks_{0};
+    std::atomic<double> measuredTickRate_{0.0};
+};
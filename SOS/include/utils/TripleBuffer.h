@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free single-producer / single-consumer triple buffer.
+ * The producer fills writeBuffer() and publish()es it; the consumer calls
+ * update() to swap in the most recently published buffer and then reads
+ * readBuffer(). Neither side ever waits, and buffers are reused so their
+ * allocations survive from one publish to the next. Intermediate publishes
+ * the consumer did not pick up in time are overwritten (latest wins);
+ * publish() reports it, so a producer that fills buffers incrementally
+ * knows the buffer it gets back was never read.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& writeBuffer() { return buffers_[writeIndex_]; }
+
+    // Returns true if the previously published buffer was not picked up; it is the new writeBuffer()
+    bool publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(writeIndex_ | FreshBit), std::memory_order_acq_rel);
+        writeIndex_ = previous & IndexMask;
+        return (previous & FreshBit) != 0;
+    }
+
+    // Consumer side. Returns true when a newer buffer was swapped in.
+    bool update() {
+        if ((middle_.load(std::memory_order_acquire) & FreshBit) == 0) {
+            return false;
+        }
+        uint8_t previous = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = previous & IndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers_[readIndex_]; }
+
+private:
+    static constexpr uint8_t IndexMask = 0x03;
+    static constexpr uint8_t FreshBit = 0x04;
+
+    std::array<T, 3> buffers_;
+    uint8_t writeIndex_ = 0;
+    std::atomic<uint8_t> middle_{1};
+    uint8_t readIndex_ = 2;
+};
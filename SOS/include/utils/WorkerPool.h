@@ -0,0 +1,46 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Small fixed-size thread pool for fork/join work inside a tick.
+ * parallelFor() hands out indices to the workers and the calling thread,
+ * and returns once every index has been processed.
+ */
+class WorkerPool {
+public:
+    // threadCount of 0 uses one worker per hardware thread (minus the caller)
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Run job(0) .. job(count - 1), blocking until all have finished.
+    // Exceptions thrown by a job are logged and do not abort the batch.
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+    size_t getThreadCount() const { return workers_.size(); }
+
+private:
+    void workerLoop();
+    // Claims and runs indices of the current batch until none are left
+    void runJobs(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable batchDone_;
+
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t jobCount_ = 0;
+    size_t nextIndex_ = 0;
+    size_t pending_ = 0;
+    uint64_t batchId_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,14 @@
+#include "DirtyTracker.h"
+#include <algorithm>
+
+void DirtyTracker::clear() {
+    for (uint16_t id : ids_) {
+        flags_[id] = 0;
+    }
+    ids_.clear();
+}
+
+void DirtyTracker::grow(uint16_t id) {
+    // Grow geometrically so IDs handed out one by one stay amortized O(1)
+    flags_.resize(std::max<size_t>(static_cast<size_t>(id) + 1, flags_.size() * 2));
+}
@@ -5,9 +5,6 @@
 #include <iostream>
 #include <mutex>
 
-uint16_t Object::objectCount = 0; // Initialize static object count
-std::mutex Object::countmutex; // Define the static mutex
-
 Object::Object(BoxCollider collider, ObjectType type, uint16_t ID)
     : collider(collider), type(type), dir(FacingDirection::EAST), ObjID(ID)
 {
@@ -29,6 +26,9 @@ void Object::updateAnimation(float deltaTime) {
 }
 
 void Object::setAnimationState(AnimationState state) {
+    if (animController.getCurrentState() != state) {
+        markDirty();
+    }
     animController.setState(state);
 }
 
@@ -56,6 +56,10 @@ void Object::addSpriteSheet(AnimationState state, std::string tpsheet, uint32_t
     animController.addSpriteSheet(tpsheet, state, frameTime);
 }
 
+void Object::addSpriteSheet(AnimationState state, SpriteData* spriteSheet, uint32_t frameTime) {
+    animController.addSpriteSheet(spriteSheet, state, frameTime);
+}
+
 const SpriteData* Object::getCurrentSpriteData() const {
     SpriteData* spData = animController.getCurrentSpriteData();
     if (spData) {
@@ -0,0 +1,35 @@
+#include "ObjectRegistry.h"
+#include <algorithm>
+
+const std::shared_ptr<Object> ObjectRegistry::empty_;
+
+bool ObjectRegistry::insert(const std::shared_ptr<Object>& object) {
+    if (!object) {
+        return false;
+    }
+    const uint16_t id = object->getObjID();
+    if (id >= slots_.size()) {
+        // Grow geometrically so IDs handed out one by one stay amortized O(1)
+        slots_.resize(std::max<size_t>(static_cast<size_t>(id) + 1, slots_.size() * 2));
+    }
+    if (slots_[id]) {
+        return false;
+    }
+    slots_[id] = object;
+    ++count_;
+    return true;
+}
+
+bool ObjectRegistry::remove(uint16_t id) {
+    if (id >= slots_.size() || !slots_[id]) {
+        return false;
+    }
+    slots_[id].reset();
+    --count_;
+    return true;
+}
+
+void ObjectRegistry::clear() {
+    slots_.clear();
+    count_ = 0;
+}
@@ -1,5 +1,27 @@
 #include "animation.h"
+#include <filesystem>
 #include <iostream>
+
+namespace {
+// Frames per direction of the sprite sheets gameplay objects animate with,
+// used in headless mode instead of counting the sprites in the atlas
+struct HeadlessAnimation {
+    const char* spriteSheet;
+    uint8_t frameCount;
+};
+
+constexpr HeadlessAnimation headlessAnimations[] = {
+    {"wolfman_idle", 2},
+    {"wolfman_walk", 8},
+    {"wolfman_slash", 5},
+    {"minotaurus_idle", 2},
+    {"minotaurus_walk", 8},
+    {"minotaurus_slash", 5},
+};
+}
+
+std::atomic<bool> AnimationController::headless_{false};
+
 AnimationController::AnimationController()
     : currentState(AnimationState::IDLE), currentFrame(0), elapsedTime(0), finished(false),lastDirection(FacingDirection::EAST), targetState(AnimationState::IDLE) {
     // Default constructor - start with IDLE state
@@ -13,6 +35,14 @@ void AnimationController::cleanupSharedResources() {
     SpriteData::spriteCache.clear();
 }
 
+void AnimationController::setHeadless(bool headless) {
+    headless_ = headless;
+}
+
+bool AnimationController::isHeadless() {
+    return headless_;
+}
+
 void AnimationController::addAnimation(AnimationState state, const AnimationDef& def) {
     animations[state] = def;
 }
@@ -136,11 +166,35 @@ SpriteData* AnimationController::getCurrentSpriteData() const {
 }
 
 void AnimationController::addSpriteSheet(const std::string& spriteSheetPath, AnimationState spriteState, uint32_t frameTime) {
-    // Create a new SpriteData object and add it to the spriteSheets map
-    SpriteData* spriteData = SpriteData::getSharedInstance(spriteSheetPath);
-    spriteSheets[spriteState] = spriteData;
+    AnimationDef def;
+    if (headless_) {
+        // Only the timing matters, take the frame count from the table
+        std::string name = std::filesystem::path(spriteSheetPath).stem().string();
+        def.frameCount = 1;
+        bool found = false;
+        for (const auto& entry : headlessAnimations) {
+            if (name == entry.spriteSheet) {
+                def.frameCount = entry.frameCount;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            std::cerr << "[AnimationController] No headless frame count for " << name << ", using 1 frame" << std::endl;
+        }
+    } else {
+        // Create a new SpriteData object and add it to the spriteSheets map
+        addSpriteSheet(SpriteData::getSharedInstance(spriteSheetPath), spriteState, frameTime);
+        return;
+    }
+    def.frameTime = frameTime; // Default frame time, can be adjusted later
+    def.loop = true; // Default to looping animations
+    animations[spriteState] = def;
+}
 
+void AnimationController::addSpriteSheet(SpriteData* spriteData, AnimationState spriteState, uint32_t frameTime) {
     AnimationDef def;
+    spriteSheets[spriteState] = spriteData;
     def.frameCount = spriteData->spriteRects.size() / 4;
     def.frameTime = frameTime; // Default frame time, can be adjusted later
     def.loop = true; // Default to looping animations
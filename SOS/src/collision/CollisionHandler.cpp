@@ -43,7 +43,8 @@ void CollisionHandler::visit(Tile* platform) {
 void CollisionHandler::handleInteraction(Player* player) {
     if (initiator->type == ObjectType::TILE) {
         // Player landed on platform
-        BoxCollider* pCollider = &player->getcollider();
+        BoxCollider collider = player->getcollider();
+        BoxCollider* pCollider = &collider;
         Vec2* pos = &pCollider->position;
         Vec2 vel = player->getvelocity();
         // Static cast to Platform to access platform-specific properties
@@ -71,7 +72,8 @@ void CollisionHandler::handleInteraction(Enemy* enemy) {
     if (initiator->type == ObjectType::TILE) {
         // Enemy landed on platform
         Tile* platform = static_cast<Tile*>(initiator);
-        BoxCollider* pCollider = &enemy->getcollider();
+        BoxCollider collider = enemy->getcollider();
+        BoxCollider* pCollider = &collider;
         Vec2* pos = &pCollider->position;
         
         // Check flags for platform collision
@@ -82,6 +84,7 @@ void CollisionHandler::handleInteraction(Enemy* enemy) {
             // Side collision
             pos->x -= info.penetrationVector.x;
         }
+        enemy->setcollider(*pCollider);
 
     } else if (initiator->type == ObjectType::PLAYER) {
         // Enemy hit by player - might take damage depending on game logic
@@ -91,19 +94,17 @@ void CollisionHandler::handleInteraction(Enemy* enemy) {
         if (initiator->getObjID() < enemy->getObjID()) {
             return; // Only one enemy should handle the collision
         }
+        Vec2 pos = enemy->getposition();
+        Vec2 vel = enemy->getvelocity();
         if(info.penetrationVector.x != 0) {
-            BoxCollider* pCollider = &enemy->getcollider();
-            Vec2* pos = &pCollider->position;
-            Vec2* vel = &enemy->getvelocity();
-            pos->x -= info.penetrationVector.x;
-            vel->x = 0;
+            pos.x -= info.penetrationVector.x;
+            vel.x = 0;
         } else if (info.penetrationVector.y != 0) {
-            BoxCollider* pCollider = &enemy->getcollider();
-            Vec2* pos = &pCollider->position;
-            Vec2* vel = &enemy->getvelocity();
-            pos->y -= info.penetrationVector.y;
-            vel->y = 0;
+            pos.y -= info.penetrationVector.y;
+            vel.y = 0;
         }
+        enemy->setposition(pos);
+        enemy->setvelocity(vel);
     }
 }
 
@@ -116,8 +116,8 @@ void CollisionManager::resolveCollision(Object* objA, Object* objB, const Collis
 bool CollisionManager::checkAndResolveCollision(Object* objA, Object* objB, 
                                       std::vector<std::pair<Object*, Object*>>& collisions, 
                                       int& collisionChecks) {
-    BoxCollider* pColliderA = &objA->getcollider();
-    BoxCollider* pColliderB = &objB->getcollider();
+    const BoxCollider* pColliderA = &objA->getcollider();
+    const BoxCollider* pColliderB = &objB->getcollider();
     Vec2 posA = pColliderA->position;
     Vec2 posB = pColliderB->position;
     
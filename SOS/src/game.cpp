@@ -56,6 +56,7 @@ Game::~Game() {
     // Clean up game objects
     // No need to manually delete objects as they are managed by shared_ptr
     objects.clear();
+    objectRegistry_.clear();
     
     delete collisionManager;
     
@@ -127,6 +128,7 @@ void Game::update(float deltaTime) {
                                     );
                                 }
                                 clearActors();
+                                objectRegistry_.remove(enemy->getObjID());
                                 return true; // Remove this enemy
                             }
                         }
@@ -244,12 +246,13 @@ bool Game::initializeSinglePlayerEmbeddedServer() {
 }
 
 
-bool Game::initializeServerConnection(const std::string& serverAddress, int serverPort, const uint16_t playerId) {
+bool Game::initializeServerConnection(const std::string& serverAddress, int serverPort, const uint16_t playerId,
+                                      const std::string& levelId) {
     if (!multiplayerManager) {
         multiplayerManager = std::make_unique<MultiplayerManager>();
     }
     
-    bool success = multiplayerManager->initialize(serverAddress, serverPort, playerId);
+    bool success = multiplayerManager->initialize(serverAddress, serverPort, playerId, levelId);
     
     if (success) {
         multiplayerActive = true;
@@ -360,10 +363,8 @@ void Game::updateRemotePlayers(const std::map<uint16_t, std::shared_ptr<Player>>
     for (const auto& pair : remotePlayers) {
         //Find the remote player in the gameobjects
         //If not found, create a new one, otherwise continue
-        auto it = std::find_if(objects.begin(), objects.end(), [&](const std::shared_ptr<Object>& obj) {
-            return obj->getObjID() == pair.first;
-        });
-        if (it == objects.end()) {
+        const std::shared_ptr<Object>& existing = objectRegistry_.find(pair.first);
+        if (!existing) {
             // Create a new remote player
             std::cout << "[Game] Creating new remote player: " << pair.first << std::endl;
             Vec2 position = pair.second->getposition();
@@ -373,27 +374,27 @@ void Game::updateRemotePlayers(const std::map<uint16_t, std::shared_ptr<Player>>
             remotePlayer->setDir(pair.second->getDir());
             remotePlayer->setAnimationState(pair.second->getAnimationState());
             
-            objects.push_back(std::shared_ptr<Player>(remotePlayer));
+            addObject(std::shared_ptr<Player>(remotePlayer));
 
         } else {
             if(player)
             {
-                if((*it)->getObjID() == player->getObjID())
+                if(existing->getObjID() == player->getObjID())
                 {
                     // Skip updating the local player
                     continue;
                 }    
             }
             Vec2 position = pair.second->getposition();
-            Vec2 oldPosition = (*it)->getposition();
+            Vec2 oldPosition = existing->getposition();
             std::cout << "[Game] Updating remote player: " << pair.first 
                       << " from " << oldPosition.x << "," << oldPosition.y 
                       << " to " << position.x << "," << position.y << std::endl;
             // Update existing remote player
-            (*it)->setcollider(pair.second->getcollider());
-            (*it)->setvelocity(pair.second->getvelocity());
-            (*it)->setDir(pair.second->getDir());
-            (*it)->setAnimationState(pair.second->getAnimationState());
+            existing->setcollider(pair.second->getcollider());
+            existing->setvelocity(pair.second->getvelocity());
+            existing->setDir(pair.second->getDir());
+            existing->setAnimationState(pair.second->getAnimationState());
         }
     }
 }
@@ -503,8 +504,8 @@ void Game::reconcileWithServerState(float deltaTime) {
         Player* remotePlayer = it->second.get();
 
         Vec2 serverPosition = remotePlayer->getTargetPosition();
-        BoxCollider* clientCollider = &player->getcollider();
-        Vec2* clientPosition = &clientCollider->position;
+        const BoxCollider* clientCollider = &player->getcollider();
+        const Vec2* clientPosition = &clientCollider->position;
         
         // Calculate position difference
         float dx = serverPosition.x - clientPosition->x;
@@ -534,19 +535,16 @@ void Game::reconcileWithServerState(float deltaTime) {
 // New method to add objects to the game
 void Game::addObject(std::shared_ptr<Object> object) {
     if (object) {
-        // Check if object with this ID already exists
-        auto it = std::find_if(objects.begin(), objects.end(), 
-                              [&](const std::shared_ptr<Object>& obj) {
-                                  return obj->getObjID() == object->getObjID();
-                              });
-        
-        if (it == objects.end()) {
-            // Add new object if it doesn't exist
-            objects.push_back(object);
-
-            if(player)
-            {
-                movePlayerToEnd();
+        // Add new object if no object with this ID exists yet
+        if (objectRegistry_.insert(object)) {
+            if (player && !objects.empty() && objects.back().get() == player) {
+                // Keep the player last without searching for it
+                objects.insert(objects.end() - 1, object);
+            } else {
+                objects.push_back(object);
+                if (player) {
+                    movePlayerToEnd();
+                }
             }
         } 
         // else {
@@ -853,6 +851,12 @@ void Game::updatePlayer(uint16_t playerId, const Vec2& position) {
         player->setInput(input); // Set input handler for the player
         multiplayerManager->setLocalPlayer(player); // Set the local player in the multiplayer manager
         multiplayerManager->setPlayerInput(input); // Set input for multiplayer manager
-        objects.push_back(std::shared_ptr<Player>(player)); // Add player to objects
+        // A copy of this ID from an earlier game state makes way for the local player
+        std::shared_ptr<Object> existing = objectRegistry_.find(playerId);
+        if (existing) {
+            objects.erase(std::remove(objects.begin(), objects.end(), existing), objects.end());
+            objectRegistry_.remove(playerId);
+        }
+        addObject(std::shared_ptr<Player>(player)); // Add player to objects
     }
 }
\ No newline at end of file
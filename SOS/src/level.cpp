@@ -1,6 +1,7 @@
 // ────────────────────────────── Level.cpp ───────────────────────────────
 #include "level.h"
 #include "AudioManager.h"
+#include "network/NetworkConfig.h"
 
 #include <iostream>
 #include <fstream>
@@ -21,13 +22,15 @@ namespace {
 /* ── ctor / dtor ──────────────────────────────────────────────────────── */
 Level::Level(const std::string& id,
              const std::string& name,
-             CollisionManager*   collisionManager)
+             CollisionManager*   collisionManager,
+             ObjectIdAllocator*  objectIds)
     : id(id),
       name(name),
+      playerStartPosition(0, 0),
       loaded(false),
       completed(false),
       collisionManager(collisionManager),
-      playerStartPosition(0, 0)
+      objectIds_(objectIds)
 {}
 
 Level::~Level() { unload(); }
@@ -67,14 +70,20 @@ bool Level::load(json& levelData)
                            ? gidMap[i+1].first - 1 : INT_MAX;
     }
 
+    /* tiles refer to their tileset by its position in this table */
+    auto tilesetNames = std::make_shared<std::vector<std::string>>();
+    for (const auto& r : gidMap)
+        tilesetNames->push_back(r.name);
+    tilesetNames_ = std::move(tilesetNames);
+
     auto gidToTileset =
-        [&](int gid, std::string& tsName, int& localId) -> bool
+        [&](int gid, std::size_t& tsIndex, int& localId) -> bool
     {
-        for (const auto& r : gidMap)
-            if (gid >= r.first && gid <= r.last)
+        for (std::size_t i = 0; i < gidMap.size(); ++i)
+            if (gid >= gidMap[i].first && gid <= gidMap[i].last)
             {
-                tsName  = r.name;
-                localId = gid - r.first;   // 0-based frame
+                tsIndex = i;
+                localId = gid - gidMap[i].first;   // 0-based frame
                 return true;
             }
         return false;
@@ -106,7 +115,7 @@ bool Level::load(json& levelData)
 
                     const int gid = static_cast<int>(rawGid);
 
-                    std::string tileset;
+                    std::size_t tileset = 0;
                     int spriteIndex = 0;
                     if (!gidToTileset(gid, tileset, spriteIndex))
                         continue;               // orphan GID – skip
@@ -114,13 +123,14 @@ bool Level::load(json& levelData)
                     const int worldX = col * tileWidth;
                     const int worldY = row * tileHeight;
 
-                    uint16_t objId = Object::getNextObjectID();
+                    uint16_t objId = objectIds_->next();
                     auto tile = std::make_shared<Tile>(
                         worldX, worldY, objId,
-                        tileset, spriteIndex,
-                        tileWidth, tileHeight, 0);
+                        gidMap[tileset].name, spriteIndex,
+                        tileWidth, tileHeight, 0,
+                        static_cast<uint16_t>(tileset));
 
-                    levelObjects.push_back(tile);
+                    insertObject(tile);
                 }
             }
         }
@@ -206,16 +216,51 @@ void Level::update(float deltaTime) {
     {
         std::lock_guard<std::mutex> lock(gameStateMutex_);
     
-        // Update all game objects
-        for (auto& object : levelObjects) {
-            object->update(deltaTime);
-            // Check if object is an entity that has health
-            if (object->type == ObjectType::PLAYER || object->type == ObjectType::MINOTAUR) {
-                std::shared_ptr<Entity> entity = std::static_pointer_cast<Entity>(object);
-                if(entity->isDead())
-                {
-                    std::cout << "[Level] Object with ID: " << object->getObjID() << " is dead, removing from level." << std::endl;
-                    objectsToRemove.push_back(object);  // Mark for removal if dead, removing directly here will cause iteration issues
+        {
+            TickProfiler::ScopedPhase phase(profiler_, TickPhase::ObjectUpdate);
+
+            // When shedding load, entities far from every player update less often
+            // with a longer step; object IDs stagger them over the stride
+            const int stride = distantUpdateStride_;
+            const uint64_t updateIndex = updateCount_++;
+            playerPositions_.clear();
+            if (stride > 1) {
+                for (const auto& object : dynamicObjects_) {
+                    if (object->type == ObjectType::PLAYER) {
+                        playerPositions_.push_back(object->getposition());
+                    }
+                }
+            }
+            auto isDistant = [&](const Object& object) {
+                const float range = NetworkConfig::Server::DistantEntityRange;
+                for (const Vec2& playerPos : playerPositions_) {
+                    float dx = object.getposition().x - playerPos.x;
+                    float dy = object.getposition().y - playerPos.y;
+                    if (dx * dx + dy * dy <= range * range) {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            // Update all game objects
+            for (auto& object : levelObjects) {
+                if (stride > 1 && object->type != ObjectType::PLAYER && object->type != ObjectType::TILE &&
+                    isDistant(*object)) {
+                    if ((updateIndex + object->getObjID()) % stride == 0) {
+                        object->update(deltaTime * stride);
+                    }
+                } else {
+                    object->update(deltaTime);
+                }
+                // Check if object is an entity that has health
+                if (object->type == ObjectType::PLAYER || object->type == ObjectType::MINOTAUR) {
+                    std::shared_ptr<Entity> entity = std::static_pointer_cast<Entity>(object);
+                    if(entity->isDead())
+                    {
+                        std::cout << "[Level] Object with ID: " << object->getObjID() << " is dead, removing from level." << std::endl;
+                        objectsToRemove.push_back(object);  // Mark for removal if dead, removing directly here will cause iteration issues
+                    }
                 }
             }
         }
@@ -224,19 +269,12 @@ void Level::update(float deltaTime) {
         for (const auto& obj : objectsToRemove) {
             removeObject(obj);
         }
-        auto timeBeforeCollision = std::chrono::steady_clock::now();
+
         // Detect and resolve collisions
+        TickProfiler::ScopedPhase phase(profiler_, TickPhase::Collision);
         detectAndResolveCollisions();
-        auto timeAfterCollision = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(timeAfterCollision - timeBeforeCollision);
-        // std::cout << "[Level] Collision detection and resolution took "
-        //           << duration.count() << " microseconds\n";
     }
     
-    // Send game state to clients periodically
-    static uint64_t updateTimer = 0;
-    updateTimer += deltaTime;
-    
     // Update audio if needed
     //audioManager->update();
 }
@@ -249,15 +287,10 @@ void Level::detectAndResolveCollisions() {
 void Level::addObject(std::shared_ptr<Object> object) {
     std::lock_guard<std::mutex> lock(gameStateMutex_);
     if (object) {
-        // Check if the object is already in the level
-        for (const auto& existingObj : levelObjects) {
-            if (existingObj->getObjID() == object->getObjID()) {
-                std::cout << "[Level] Object with ID " << object->getObjID() << " already exists in level" << std::endl;
-                return; // Skip duplicate objects
-            }
+        // Skip duplicate objects
+        if (!insertObject(object)) {
+            return;
         }
-        
-        levelObjects.push_back(object);
         std::cout << "[Level] Added object with ID: " << object->getObjID() << std::endl;
     } else {
         std::cerr << "[Level] Attempted to add null object to level" << std::endl;
@@ -276,6 +309,7 @@ void Level::reset() {
 
 void Level::unload() {
     // Unload level resources
+    untrackObjects();
     levelObjects.clear();
     loaded = false;
     //unload all audio
@@ -284,7 +318,13 @@ void Level::unload() {
 void Level::removeObject(std::shared_ptr<Object> object) {
     auto it = std::remove(levelObjects.begin(), levelObjects.end(), object);
     if (it != levelObjects.end()) {
+        object->setDirtyTracker(nullptr);
+        objectsById_.remove(object->getObjID());
         levelObjects.erase(it, levelObjects.end());
+        if (object->type != ObjectType::TILE) {
+            dynamicObjects_.erase(std::remove(dynamicObjects_.begin(), dynamicObjects_.end(), object),
+                                  dynamicObjects_.end());
+        }
         // std::cout << "[Level] Removed object with ID: " << object->getObjID() << std::endl;
     } else {
         std::cerr << "[Level] Object with ID: " << object->getObjID() << " not found in level" << std::endl;
@@ -293,6 +333,7 @@ void Level::removeObject(std::shared_ptr<Object> object) {
 
 bool Level::removeAllObjects() {
     std::lock_guard<std::mutex> lock(gameStateMutex_);
+    untrackObjects();
     levelObjects.clear();
     std::cout << "[Level] Cleared all objects from level" << std::endl;
     return true;
@@ -300,12 +341,12 @@ bool Level::removeAllObjects() {
 
 std::shared_ptr<Minotaur> Level::spawnMinotaur(int x, int y) {
     
-    uint16_t nextObjId = Object::getNextObjectID();
+    uint16_t nextObjId = objectIds_->next();
     // Create a new minotaur at the specified position
     std::shared_ptr<Minotaur> minotaur = std::make_shared<Minotaur>(x, y, nextObjId);
     
     // Add the minotaur to the level objects
-    levelObjects.push_back(minotaur);
+    insertObject(minotaur);
     
     std::cout << "Spawned Minotaur at position (" << x << ", " << y << ") with ID: " << nextObjId << std::endl;
     
@@ -331,4 +372,30 @@ void Level::setAllEnemiesToTargetPlayer(std::shared_ptr<Player> player) {
         }
         // Use dynamic_cast to check if this object is an Enemy
     }
-}
\ No newline at end of file
+}
+
+bool Level::insertObject(const std::shared_ptr<Object>& object) {
+    // Snapshots and clients look objects up by ID, it has to be unique in the level
+    if (!objectsById_.insert(object)) {
+        std::cerr << "[Level] Object with ID " << object->getObjID() << " already exists in level" << std::endl;
+        return false;
+    }
+    object->setDirtyTracker(&dirtyTracker_);
+    dirtyTracker_.mark(object->getObjID());
+    levelObjects.push_back(object);
+    if (object->type != ObjectType::TILE) {
+        dynamicObjects_.push_back(object);
+    }
+    return true;
+}
+
+void Level::untrackObjects() {
+    for (auto& object : levelObjects) {
+        if (object) {
+            object->setDirtyTracker(nullptr);
+        }
+    }
+    dirtyTracker_.clear();
+    objectsById_.clear();
+    dynamicObjects_.clear();
+}
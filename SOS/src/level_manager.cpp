@@ -1,16 +1,16 @@
 #include "level_manager.h"
 #include <nlohmann/json.hpp>
 #include <iostream>
-#include "player_manager.h"
+#include "network/NetworkConfig.h"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
-LevelManager::LevelManager(const std::filesystem::path& basePath)
-    : basePath(basePath)
+LevelManager::LevelManager(const std::filesystem::path& basePath, bool parallelUpdate)
+    : parallelUpdate_(parallelUpdate),
+      basePath(basePath)
 {
     // Initialize the level manager
-    collisionManager = new CollisionManager();
     currentLevel_ = nullptr;
 }
 
@@ -53,7 +53,10 @@ bool LevelManager::initialize() {
             auto name = j.at("name").get<std::string>();
 
             // register Level object and its file path
-            levels_[id]         = std::make_shared<Level>(id, name, collisionManager);
+            // Every level gets its own collision manager so levels can tick concurrently
+            collisionManagers_[id] = std::make_unique<CollisionManager>();
+            levels_[id]         = std::make_shared<Level>(id, name, collisionManagers_[id].get(), &objectIds_);
+            levels_[id]->setProfiler(profiler_);
             levelFilePaths_[id] = entry.path();
 
             std::cout << "[LevelManager] Registered level '"
@@ -80,91 +83,69 @@ bool LevelManager::initialize() {
 
 
 
+Level* LevelManager::activateLevel(const std::string& levelId) {
+    // Already simulated, nothing to load
+    for (const auto& level : activeLevels_) {
+        if (level->getId() == levelId) {
+            return level.get();
+        }
+    }
+
+    auto it = levels_.find(levelId);
+    if (it == levels_.end()) {
+        std::cerr << "[LevelManager] Level ID not found: " << levelId << std::endl;
+        return nullptr;
+    }
+
+    // Deactivated when its last player left, it continues from where it stopped
+    if (loadedLevels_.count(levelId)) {
+        activeLevels_.push_back(it->second);
+        std::cout << "[LevelManager] Reactivated level: " << levelId << " (" << activeLevels_.size()
+                  << " active levels)" << std::endl;
+        return it->second.get();
+    }
+    std::cout << "[LevelManager] Loading level: " << levelId << std::endl;
+
+    // Load the JSON level data file
+    std::string levelFilePath = levelFilePaths_[levelId];  // Use the path we already stored during initialization
+    std::ifstream levelFile(levelFilePath);
+    if (!levelFile.is_open()) {
+        std::cerr << "Failed to open level file: " << levelFilePath << std::endl;
+        return nullptr;
+    }
+    std::cout << "[LevelManager] Loading level from file: " << levelFilePath << std::endl;
+    try {
+        json levelData;
+        levelFile >> levelData;
+
+        if (!it->second->load(levelData)) {
+            std::cerr << "[LevelManager] Failed to load level data from JSON" << std::endl;
+        }
+    } catch (json::exception& e) {
+        std::cerr << "[LevelManager] JSON error: " << e.what() << std::endl;
+        return nullptr;
+    } catch (std::exception& e) {
+        std::cerr << "[LevelManager] Error loading level: " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    loadedLevels_.insert(levelId);
+    activeLevels_.push_back(it->second);
+    std::cout << "[LevelManager] Loaded level: " << levelId << " (" << activeLevels_.size()
+              << " active levels)" << std::endl;
+    return it->second.get();
+}
+
 bool LevelManager::loadLevel(const std::string& levelId) {
     // if current level is already loaded, dont reload it
     if (currentLevel_ && currentLevel_->getId() == levelId) {
-        //std::cout << "[LevelManager] Level " << levelId << " is already loaded." << std::endl;
         return true;
     }
-    auto it = levels_.find(levelId);
-    bool loaded = false;
-    std::cout << "[LevelManager] Loading level: " << levelId << std::endl;  
-    if (it != levels_.end()) {
-        currentLevel_ = it->second;
-        
-        // Load the JSON level data file
-        std::string levelFilePath = levelFilePaths_[levelId];  // Use the path we already stored during initialization
-        std::ifstream levelFile(levelFilePath);
-        
-        if (!levelFile.is_open()) {
-            std::cerr << "Failed to open level file: " << levelFilePath << std::endl;
-            loaded = false;
-        }
-        std::cout << "[LevelManager] Loading level from file: " << levelFilePath << std::endl;
-        try {
-            json levelData;
-            levelFile >> levelData;
-            
-            // First load the level data
-            bool loadSuccess = currentLevel_->load(levelData);
-            if (!loadSuccess) {
-                std::cerr << "[LevelManager] Failed to load level data from JSON" << std::endl;
-                loaded = false;
-            }
-            
-            // Example: Spawn a minotaur in the level near the player start position plus an offset
-            //Vec2 playerStart = currentLevel_->getPlayerStartPosition();
-            
-            // Spawn a minotaur slightly to the right of the player start position
-            // if (auto minotaur = currentLevel_->spawnMinotaur(playerStart.x + 300, playerStart.y)) {
-            //     std::cout << "[LevelManager] Spawned a minotaur in level " << levelId << std::endl;
-            // }
-            
-            // Example: Spawn more minotaurs at different positions if desired
-            //currentLevel_->spawnMinotaur(playerStart.x + 600, playerStart.y + 100);
-            // currentLevel_->spawnMinotaur(playerStart.x - 600, playerStart.y + 200);
-            
-            // Set all enemies in the level to target any existing players
-            for (auto& playerPair : PlayerManager::getInstance().getAllPlayers()) {
-                currentLevel_->setAllEnemiesToTargetPlayer(playerPair.second);
-            }
-            
-            // Get all existing players from PlayerManager and add them to this level
-            auto& playerManager = PlayerManager::getInstance();
-            const auto& players = playerManager.getAllPlayers();
-            for (const auto& playerPair : players) {
-                // Check if the player already exists in the level before adding
-                bool playerExists = false;
-                const auto& levelObjects = currentLevel_->getObjects();
-                
-                for (const auto& obj : levelObjects) {
-                    if (obj->getObjID() == playerPair.first) {
-                        playerExists = true;
-                        std::cout << "[LevelManager] Player " << playerPair.first << " already exists in level " << levelId << std::endl;
-                        break;
-                    }
-                }
-                
-                // if (!playerExists) {
-
-                //     addPlayerToCurrentLevel(playerPair.first);
-                // }
-            }
-            std::cout << "[LevelManager] Loaded level: " << levelId << std::endl;
-            return true;
-        } catch (json::exception& e) {
-            std::cerr << "[LevelManager] JSON error: " << e.what() << std::endl;
-            loaded = false;
-        } catch (std::exception& e) {
-            std::cerr << "[LevelManager] Error loading level: " << e.what() << std::endl;
-            loaded = false;
-        }
-    } else {
-        std::cerr << "[LevelManager] Level ID not found: " << levelId << std::endl;
-        loaded = false;
+    if (!activateLevel(levelId)) {
+        return false;
     }
-    
-    return loaded;
+    currentLevel_ = levels_[levelId];
+    return true;
 }
 
 Level* LevelManager::getCurrentLevel() const {
@@ -178,6 +159,15 @@ Level* LevelManager::getLevel(const std::string& levelId) {
     }
     return nullptr;
 }
+
+Level* LevelManager::getLevelForPlayer(uint16_t playerId) const {
+    auto it = playerLevels_.find(playerId);
+    if (it != playerLevels_.end()) {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
 bool LevelManager::loadNextLevel() {
     if (currentLevel_) {
         auto it = std::find_if(levels_.begin(), levels_.end(),
@@ -223,65 +213,137 @@ bool LevelManager::addPlayerToCurrentLevel(uint16_t playerId) {
         std::cerr << "[LevelManager] No current level to add player to" << std::endl;
         return false;
     }
-    std::cout << "[LevelManager] Adding player " << playerId << " to current level" << std::endl;
+    return addPlayerToLevel(playerId, currentLevel_->getId());
+}
+
+bool LevelManager::addPlayerToLevel(uint16_t playerId, const std::string& levelId) {
+    Level* target = activateLevel(levelId);
+    if (!target) {
+        std::cerr << "[LevelManager] Cannot add player " << playerId << " to unknown level " << levelId << std::endl;
+        return false;
+    }
+    std::cout << "[LevelManager] Adding player " << playerId << " to level " << levelId << std::endl;
+
+    // A player lives in exactly one level
+    std::shared_ptr<Level> previous = detachPlayer(playerId);
     
     // Get or create the player using PlayerManager
-    auto& playerManager = PlayerManager::getInstance();
-    auto player = playerManager.getPlayer(playerId);
+    auto player = playerManager_.getPlayer(playerId);
     
     // Get the level's player start position
-    Vec2 startPos = currentLevel_->getPlayerStartPosition();
-    std::cout << "[LevelManager] Player start position for level " << currentLevel_->getId() 
+    Vec2 startPos = target->getPlayerStartPosition();
+    std::cout << "[LevelManager] Player start position for level " << levelId 
               << ": " << startPos.x << "," << startPos.y << std::endl;
     // If the player doesn't exist yet, create a new one
     if (!player) {
-        player = playerManager.createPlayer(playerId, startPos);
+        player = playerManager_.createPlayer(playerId, startPos);
     } else {
         // For existing players, update their position to the level's start position
-        Vec2* playerPos = &player->getcollider().position;
-        playerPos->x = startPos.x;
-        playerPos->y = startPos.y;
+        player->setposition(startPos);
         std::cout << "[LevelManager] Repositioned player " << playerId 
-                  << " to level start position: " << playerPos->x << "," << playerPos->y << std::endl;
+                  << " to level start position: " << startPos.x << "," << startPos.y << std::endl;
     }
     
-    // Add the player to the current level
-    currentLevel_->addObject(player);
-    currentLevel_->setAllEnemiesToTargetPlayer(player);
-    std::cout << "[LevelManager] Added player " << playerId << " to current level" << std::endl;
+    target->addObject(player);
+    target->setAllEnemiesToTargetPlayer(player);
+    playerLevels_[playerId] = levels_[levelId];
+    std::cout << "[LevelManager] Added player " << playerId << " to level " << levelId << std::endl;
     
+    // Only now, leaving and re-entering the same level must not deactivate it
+    if (previous) {
+        deactivateIfEmpty(previous);
+    }
+    return true;
+}
+
+bool LevelManager::removePlayer(uint16_t playerId) {
+    std::shared_ptr<Level> level = detachPlayer(playerId);
+    if (!level) {
+        return false;
+    }
+    deactivateIfEmpty(level);
     return true;
 }
 
-// Update the active level
+std::shared_ptr<Level> LevelManager::detachPlayer(uint16_t playerId) {
+    auto it = playerLevels_.find(playerId);
+    if (it == playerLevels_.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<Level> level = it->second;
+    auto player = playerManager_.getPlayer(playerId);
+    if (player) {
+        level->removeObject(player);
+    }
+    std::cout << "[LevelManager] Removed player " << playerId << " from level " << level->getId() << std::endl;
+    playerLevels_.erase(it);
+    return level;
+}
+
+void LevelManager::deactivateIfEmpty(const std::shared_ptr<Level>& level) {
+    for (const auto& [playerId, playerLevel] : playerLevels_) {
+        if (playerLevel == level) {
+            return;
+        }
+    }
+    auto it = std::find(activeLevels_.begin(), activeLevels_.end(), level);
+    if (it != activeLevels_.end()) {
+        activeLevels_.erase(it);
+        std::cout << "[LevelManager] Deactivated empty level: " << level->getId() << " (" << activeLevels_.size()
+                  << " active levels)" << std::endl;
+    }
+}
+
+// Update every active level, independent levels tick in parallel
 void LevelManager::update(float deltaTime) {
-    if (currentLevel_) {
-        currentLevel_->update(deltaTime);
+    auto updateLevel = [this, deltaTime](size_t index) {
+        activeLevels_[index]->setDistantUpdateStride(distantUpdateStride_);
+        activeLevels_[index]->update(deltaTime);
+    };
+    // The pool's threads only pay off once there is more than one level to tick
+    if (parallelUpdate_ && !workerPool_ && activeLevels_.size() > 1) {
+        workerPool_ = std::make_unique<WorkerPool>(NetworkConfig::Server::LevelWorkerThreads);
+        std::cout << "[LevelManager] Started level worker pool with " << workerPool_->getThreadCount()
+                  << " threads" << std::endl;
+    }
+    if (workerPool_ && activeLevels_.size() > 1) {
+        workerPool_->parallelFor(activeLevels_.size(), updateLevel);
+    } else {
+        for (size_t i = 0; i < activeLevels_.size(); ++i) {
+            updateLevel(i);
+        }
+    }
+}
+
+void LevelManager::setProfiler(TickProfiler* profiler) {
+    profiler_ = profiler;
+    for (auto& levelPair : levels_) {
+        levelPair.second->setProfiler(profiler);
     }
 }
 
 bool LevelManager::removePlayerFromCurrentLevel(uint16_t playerId) {
-    if (currentLevel_) {
-        auto& playerManager = PlayerManager::getInstance();
-        auto player = playerManager.getPlayer(playerId);
-        
-        if (player) {
-            currentLevel_->removeObject(player);
-            std::cout << "[LevelManager] Removed player " << playerId << " from current level" << std::endl;
-            return true;
-        }
+    if (currentLevel_ && getLevelForPlayer(playerId) == currentLevel_.get()) {
+        return removePlayer(playerId);
     }
     return false;
 }
 bool LevelManager::removeAllPlayersFromCurrentLevel() {
     if (currentLevel_) {
-        auto& playerManager = PlayerManager::getInstance();
-        const auto& players = playerManager.getAllPlayers();
+        for (auto it = playerLevels_.begin(); it != playerLevels_.end();) {
+            if (it->second == currentLevel_) {
+                it = playerLevels_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        const auto& players = playerManager_.getAllPlayers();
         
         for (const auto& playerPair : players) {
             currentLevel_->removeObject(playerPair.second);
             std::cout << "[LevelManager] Removed player " << playerPair.first << " from current level" << std::endl;
         }
+        deactivateIfEmpty(currentLevel_);
         return true;
     }
     return false;
@@ -294,4 +356,20 @@ bool LevelManager::removeAllObjectsFromCurrentLevel() {
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+void LevelManager::clearLoadedLevels() {
+    // Deactivated levels keep their objects too, so go over everything that was loaded
+    for (const auto& levelId : loadedLevels_) {
+        auto it = levels_.find(levelId);
+        if (it != levels_.end()) {
+            it->second->removeAllObjects();
+        }
+    }
+    std::cout << "[LevelManager] Cleared " << loadedLevels_.size() << " loaded levels" << std::endl;
+    // Emptied, the next activation loads them from their files again
+    loadedLevels_.clear();
+    playerLevels_.clear();
+    activeLevels_.clear();
+    currentLevel_.reset();
+}
@@ -1,12 +1,17 @@
 #include "network/AsioNetworkClient.h"
+#include "network/NetworkConfig.h"
+#include "utils/LzCodec.h"
 #include <iostream>
 #include <functional>
+#include <cstring>
 
 AsioNetworkClient::AsioNetworkClient() 
     : socket_(io_context_), 
       connected_(false), 
-      server_port_(0) {
-    read_buffer_.resize(max_buffer_size);
+      server_port_(0),
+      client_id_(0),
+      udp_channel_(io_context_),
+      udp_hello_timer_(io_context_) {
 }
 
 AsioNetworkClient::~AsioNetworkClient() {
@@ -100,6 +105,12 @@ void AsioNetworkClient::disconnect() {
             work_guard_.reset();
         }
 
+        // The IO thread is gone, so the UDP side channel can be torn down directly
+        udp_hello_timer_.cancel();
+        udp_channel_.close();
+        udp_active_ = false;
+        udp_ready_pending_ = false;
+
         connected_ = false;
     } catch (const std::exception& e) {
         std::cerr << "Error during disconnect: " << e.what() << std::endl;
@@ -112,6 +123,14 @@ bool AsioNetworkClient::sendMessage(const NetworkMessage& message) {
         return false;
     }
     
+    // Latest-wins state goes over UDP once the side channel is up
+    if (udp_active_ && (message.type == MessageType::PLAYER_INPUT || message.type == MessageType::PLAYER_POSITION)) {
+        NetworkMessage datagramMessage = message;
+        datagramMessage.senderId = client_id_ ? client_id_ : message.senderId;
+        udp_channel_.send(udp_server_endpoint_, DatagramChannel::encode(++udp_send_sequence_, datagramMessage));
+        return true;
+    }
+    
     try {
         // Create a binary message as shared_ptr to manage message lifetime
         auto buffer_ptr = std::make_shared<std::vector<uint8_t>>();
@@ -193,6 +212,13 @@ void AsioNetworkClient::setClientId(const uint16_t clientId) {
 }
 
 void AsioNetworkClient::update() {
+    // Sent from here so TCP writes keep coming from the game thread only
+    if (udp_ready_pending_.exchange(false)) {
+        NetworkMessage readyMsg;
+        readyMsg.type = MessageType::UDP_READY;
+        readyMsg.senderId = client_id_;
+        sendMessage(readyMsg);
+    }
     processMessageQueue();
 }
 
@@ -219,48 +245,18 @@ void AsioNetworkClient::startRead() {
 
     // First, read the message header to know the size
     boost::asio::async_read(socket_,
-        boost::asio::buffer(&read_buffer_[0], sizeof(MessageHeader)),
+        boost::asio::buffer(&read_header_, sizeof(MessageHeader)),
         [this](const boost::system::error_code& error, std::size_t bytes_transferred) {
             if (!error && bytes_transferred == sizeof(MessageHeader)) {
-                // Read the message header
-                MessageHeader* header = reinterpret_cast<MessageHeader*>(read_buffer_.data());
-
-                // Log raw header data for debugging
-                // std::cout << "[Network] Raw header data: ";
-                // for (size_t i = 0; i < sizeof(MessageHeader); ++i) {
-                //     std::cout << std::hex << static_cast<int>(read_buffer_[i]) << " ";
-                // }
-                // std::cout << std::dec << std::endl;
-
-                // Sanity check for message size
-                if (header->size <= 0 || header->size >= max_buffer_size) {
-                    // std::cerr << "[Network] Invalid message size: " << header->size << std::endl;
-                    startRead(); // Restart reading
+                // Frames of any size are read, only a corrupt length stops the stream
+                if (read_header_.size < MessageBodyHeaderSize || read_header_.size > NetworkConfig::MaxFrameSize) {
+                    std::cerr << "[Network] Invalid message size " << read_header_.size << ", closing connection" << std::endl;
+                    connected_ = false;
+                    boost::system::error_code ec;
+                    socket_.close(ec);
                     return;
                 }
-
-                // Now read the message body
-                boost::asio::async_read(socket_,
-                    boost::asio::buffer(&read_buffer_[sizeof(MessageHeader)], header->size),
-                    [this, header](const boost::system::error_code& error, std::size_t bytes_transferred) {
-                        if (!error && bytes_transferred == header->size) {
-                            // Process the complete message
-                            std::vector<uint8_t> messageData(
-                                read_buffer_.begin() + sizeof(MessageHeader),
-                                read_buffer_.begin() + sizeof(MessageHeader) + header->size
-                            );
-
-                            // Deserialize and add to queue
-                            NetworkMessage message = deserializeMessage(messageData);
-                            std::lock_guard<std::mutex> lock(message_mutex_);
-                            received_messages_.push(message);
-                        } else if (error) {
-                            std::cerr << "[Network] Error reading message body: " << error.message() << std::endl;
-                        }
-
-                        // Continue reading
-                        startRead();
-                    });
+                readBody(read_header_.size);
             } else if (error != boost::asio::error::operation_aborted) {
                 // Handle error but don't restart if we're intentionally shutting down
                 if (connected_) {
@@ -271,26 +267,204 @@ void AsioNetworkClient::startRead() {
         });
 }
 
-void AsioNetworkClient::handleRead(const boost::system::error_code& error, size_t bytesTransferred) {
-    if (!error) {
-        // If we successfully read data, process it
-        if (bytesTransferred > 0) {
-            // Deserialize the message
-            std::vector<uint8_t> messageData(read_buffer_.begin(), read_buffer_.begin() + bytesTransferred);
-            NetworkMessage message = deserializeMessage(messageData);
-            
-            // Add to the received message queue
-            std::lock_guard<std::mutex> lock(message_mutex_);
-            received_messages_.push(message);
+void AsioNetworkClient::readBody(uint32_t size) {
+    // Scatter the body: the fixed message header into a small array, the payload
+    // straight into the buffer that becomes NetworkMessage::data (grown to fit)
+    read_payload_ = buffer_pool_.acquire(size - MessageBodyHeaderSize);
+    std::array<boost::asio::mutable_buffer, 2> buffers = {
+        boost::asio::buffer(read_message_header_),
+        boost::asio::buffer(read_payload_),
+    };
+    boost::asio::async_read(socket_, buffers,
+        [this, size](const boost::system::error_code& error, std::size_t bytes_transferred) {
+            if (!error && bytes_transferred == size) {
+                NetworkMessage message;
+                uint32_t dataSize = 0;
+                decodeMessageHeader(read_message_header_.data(), message, dataSize);
+                // A length beyond the frame means a corrupt message, its data is dropped
+                if (dataSize <= read_payload_.size()) {
+                    read_payload_.resize(dataSize);
+                } else {
+                    read_payload_.clear();
+                }
+                message.data = std::move(read_payload_);
+                
+                if (message.type == MessageType::BUNDLE) {
+                    unpackBundle(message);
+                    buffer_pool_.release(std::move(message.data));
+                } else if (message.type == MessageType::UDP_OFFER) {
+                    handleUdpOffer(message);
+                    buffer_pool_.release(std::move(message.data));
+                } else if (message.type != MessageType::GAME_STATE_COMPRESSED || inflateGameState(message)) {
+                    queueMessage(std::move(message));
+                }
+            } else if (error) {
+                if (error == boost::asio::error::operation_aborted) {
+                    return;
+                }
+                std::cerr << "[Network] Error reading message body: " << error.message() << std::endl;
+            }
+
+            // Continue reading
+            startRead();
+        });
+}
+
+void AsioNetworkClient::queueMessage(NetworkMessage&& message) {
+    std::lock_guard<std::mutex> lock(message_mutex_);
+    received_messages_.push_back(std::move(message));
+}
+
+void AsioNetworkClient::unpackBundle(const NetworkMessage& bundle) {
+    const uint8_t* data = bundle.data.data();
+    const size_t size = bundle.data.size();
+    size_t offset = 0;
+    
+    // Decoded without the lock, then handed over in one go
+    while (offset + MessageBodyHeaderSize <= size) {
+        NetworkMessage message;
+        uint32_t dataSize = 0;
+        decodeMessageHeader(data + offset, message, dataSize);
+        offset += MessageBodyHeaderSize;
+        if (dataSize > size - offset) {
+            std::cerr << "[Network] Truncated message in bundle, dropping the rest" << std::endl;
+            break;
         }
+        message.data = buffer_pool_.acquire(dataSize);
+        std::memcpy(message.data.data(), data + offset, dataSize);
+        offset += dataSize;
         
-        // Start another read operation
-        startRead();
-    } else if (error != boost::asio::error::operation_aborted) {
-        // Error occurred
-        std::cerr << "HandleRead Read error: " << error.message() << std::endl;
-        connected_ = false;
+        if (message.type == MessageType::UDP_OFFER) {
+            handleUdpOffer(message);
+            buffer_pool_.release(std::move(message.data));
+        } else if (message.type != MessageType::GAME_STATE_COMPRESSED || inflateGameState(message)) {
+            bundle_messages_.push_back(std::move(message));
+        }
     }
+    
+    std::lock_guard<std::mutex> lock(message_mutex_);
+    for (NetworkMessage& message : bundle_messages_) {
+        received_messages_.push_back(std::move(message));
+    }
+    bundle_messages_.clear();
+}
+
+bool AsioNetworkClient::inflateGameState(NetworkMessage& message) {
+    // Payload: [u32 BE original size][LzCodec block]
+    const auto& d = message.data;
+    bool ok = d.size() >= sizeof(uint32_t);
+    if (ok) {
+        uint32_t originalSize = (static_cast<uint32_t>(d[0]) << 24) | (static_cast<uint32_t>(d[1]) << 16) |
+                                (static_cast<uint32_t>(d[2]) << 8) | static_cast<uint32_t>(d[3]);
+        ok = originalSize <= NetworkConfig::MaxFrameSize;
+        if (ok) {
+            BufferPool::Buffer inflated = buffer_pool_.acquire(originalSize);
+            ok = LzCodec::decompress(d.data() + sizeof(uint32_t), d.size() - sizeof(uint32_t),
+                                     inflated.data(), originalSize);
+            std::swap(message.data, inflated);
+            buffer_pool_.release(std::move(inflated));
+        }
+    }
+    if (!ok) {
+        std::cerr << "[Network] Corrupt compressed game state dropped" << std::endl;
+        buffer_pool_.release(std::move(message.data));
+        return false;
+    }
+    message.type = MessageType::GAME_STATE;
+    return true;
+}
+
+void AsioNetworkClient::handleUdpOffer(const NetworkMessage& message) {
+    if (!NetworkConfig::Client::UseUdpChannel || message.data.size() < 6) {
+        return;
+    }
+    boost::system::error_code ec;
+    auto serverEndpoint = socket_.remote_endpoint(ec);
+    if (ec) {
+        return;
+    }
+    
+    // Payload: [u16 BE port][u32 BE token]
+    const auto& d = message.data;
+    uint16_t udpPort = static_cast<uint16_t>((d[0] << 8) | d[1]);
+    udp_token_ = (static_cast<uint32_t>(d[2]) << 24) | (static_cast<uint32_t>(d[3]) << 16) |
+                 (static_cast<uint32_t>(d[4]) << 8) | static_cast<uint32_t>(d[5]);
+    udp_server_endpoint_ = DatagramChannel::Endpoint(serverEndpoint.address(), udpPort);
+    udp_active_ = false;
+    udp_received_any_ = false;
+    
+    auto protocol = serverEndpoint.address().is_v6() ? boost::asio::ip::udp::v6() : boost::asio::ip::udp::v4();
+    if (!udp_channel_.open(DatagramChannel::Endpoint(protocol, 0))) {
+        std::cerr << "[Network] Could not open UDP socket, staying on TCP" << std::endl;
+        return;
+    }
+    udp_channel_.startReceive([this](const DatagramChannel::Endpoint& from, uint32_t sequence,
+                                     const uint8_t* body, size_t size) {
+        handleDatagram(from, sequence, body, size);
+    });
+    std::cout << "[Network] Server offers UDP side channel on port " << udpPort << std::endl;
+    
+    udp_hello_attempts_ = 0;
+    sendUdpHello();
+}
+
+void AsioNetworkClient::sendUdpHello() {
+    if (udp_active_ || !connected_) {
+        return;
+    }
+    if (udp_hello_attempts_++ >= NetworkConfig::Client::UdpHelloAttempts) {
+        std::cerr << "[Network] No UDP reply from server, staying on TCP" << std::endl;
+        return;
+    }
+    
+    NetworkMessage hello;
+    hello.type = MessageType::UDP_HELLO;
+    hello.senderId = client_id_;
+    hello.data = {
+        static_cast<uint8_t>(udp_token_ >> 24), static_cast<uint8_t>((udp_token_ >> 16) & 0xFF),
+        static_cast<uint8_t>((udp_token_ >> 8) & 0xFF), static_cast<uint8_t>(udp_token_ & 0xFF),
+    };
+    udp_channel_.send(udp_server_endpoint_, DatagramChannel::encode(0, hello));
+    
+    udp_hello_timer_.expires_after(std::chrono::milliseconds(NetworkConfig::Client::UdpHelloInterval));
+    udp_hello_timer_.async_wait([this](const boost::system::error_code& error) {
+        if (!error) {
+            sendUdpHello();
+        }
+    });
+}
+
+void AsioNetworkClient::handleDatagram(const DatagramChannel::Endpoint& from, uint32_t sequence,
+                                       const uint8_t* body, size_t size) {
+    if (from != udp_server_endpoint_) {
+        return;
+    }
+    NetworkMessage message = deserializeMessage(body, size);
+    
+    // The server echoed our handshake, datagrams work both ways
+    if (message.type == MessageType::UDP_HELLO) {
+        if (!udp_active_.exchange(true)) {
+            udp_hello_timer_.cancel();
+            udp_ready_pending_ = true;
+            std::cout << "[Network] UDP side channel established" << std::endl;
+        }
+        buffer_pool_.release(std::move(message.data));
+        return;
+    }
+    if (!udp_active_) {
+        buffer_pool_.release(std::move(message.data));
+        return;
+    }
+    
+    // Datagrams of one snapshot share its sequence, anything older is stale
+    if (udp_received_any_ && DatagramChannel::isNewer(udp_last_received_, sequence)) {
+        buffer_pool_.release(std::move(message.data));
+        return;
+    }
+    udp_received_any_ = true;
+    udp_last_received_ = sequence;
+    
+    queueMessage(std::move(message));
 }
 
 void AsioNetworkClient::handleWrite(const boost::system::error_code& error) {
@@ -301,22 +475,23 @@ void AsioNetworkClient::handleWrite(const boost::system::error_code& error) {
 }
 
 void AsioNetworkClient::processMessageQueue() {
-    std::lock_guard<std::mutex> lock(message_mutex_);
-    
-    if (!received_messages_.empty()) {
-        // std::cout << "[Network] Processing " << received_messages_.size() << " received messages" << std::endl;
+    {
+        // Take the whole batch; the IO thread keeps filling the other vector meanwhile
+        std::lock_guard<std::mutex> lock(message_mutex_);
+        processing_messages_.swap(received_messages_);
     }
     
-    while (!received_messages_.empty()) {
+    for (NetworkMessage& message : processing_messages_) {
+        // Messages are moved through the queue, the handler sees the buffer the socket filled
         if (message_handler_) {
-            // std::cout << "[Network] Dispatching message type: " << static_cast<int>(received_messages_.front().type) 
-            //           << " from " << received_messages_.front().senderId << std::endl;
-            message_handler_(received_messages_.front());
+            message_handler_(message);
         } else {
             std::cerr << "[Network] Warning: No message handler registered" << std::endl;
         }
-        received_messages_.pop();
+        buffer_pool_.release(std::move(message.data));
     }
+    // Both vectors keep their capacity, so steady state does not allocate
+    processing_messages_.clear();
 }
 
 // Simple serialization/deserialization for this example
@@ -344,40 +519,38 @@ std::vector<uint8_t> AsioNetworkClient::serializeMessage(const NetworkMessage& m
     return result;
 }
 
-NetworkMessage AsioNetworkClient::deserializeMessage(const std::vector<uint8_t>& data) {
-    NetworkMessage message;
-    size_t offset = 0;
-    
-    if (data.empty()) return message;
-    
+void AsioNetworkClient::decodeMessageHeader(const uint8_t* header, NetworkMessage& message, uint32_t& dataSize) {
     // 1. Message type
-    message.type = static_cast<MessageType>(data[offset++]);
-    
-    if (offset >= data.size()) return message;
+    message.type = static_cast<MessageType>(header[0]);
     
     // 2. Sender ID 2 bytes
-    message.senderId = 0;
-    if (offset + 2 <= data.size()) {
-        message.senderId = (static_cast<uint16_t>(data[offset]) << 8) |
-                           static_cast<uint16_t>(data[offset + 1]);
-        offset += 2;
-    }
-    
+    message.senderId = (static_cast<uint16_t>(header[1]) << 8) |
+                       static_cast<uint16_t>(header[2]);
     
-    if (offset + 4 > data.size()) return message;
+    // 3. Data length
+    dataSize = (static_cast<uint32_t>(header[3]) << 24) |
+               (static_cast<uint32_t>(header[4]) << 16) |
+               (static_cast<uint32_t>(header[5]) << 8) |
+               static_cast<uint32_t>(header[6]);
+}
+
+NetworkMessage AsioNetworkClient::deserializeMessage(const uint8_t* data, size_t size) {
+    NetworkMessage message;
+    if (size < MessageBodyHeaderSize) {
+        if (size > 0) {
+            message.type = static_cast<MessageType>(data[0]);
+        }
+        return message;
+    }
     
-    // 4. Data length
-    uint32_t dataSize = 
-        (static_cast<uint32_t>(data[offset]) << 24) |
-        (static_cast<uint32_t>(data[offset + 1]) << 16) |
-        (static_cast<uint32_t>(data[offset + 2]) << 8) |
-        static_cast<uint32_t>(data[offset + 3]);
-    offset += 4;
+    uint32_t dataSize = 0;
+    decodeMessageHeader(data, message, dataSize);
     
-    // 5. Data content
-    if (offset + dataSize <= data.size()) {
-        message.data.assign(data.begin() + offset, data.begin() + offset + dataSize);
+    // 4. Data content
+    if (MessageBodyHeaderSize + dataSize <= size) {
+        message.data = buffer_pool_.acquire(dataSize);
+        std::memcpy(message.data.data(), data + MessageBodyHeaderSize, dataSize);
     }
     
     return message;
-}
\ No newline at end of file
+}
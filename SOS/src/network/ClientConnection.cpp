@@ -0,0 +1,250 @@
+#include "network/ClientConnection.h"
+#include "network/NetworkConfig.h"
+#include <iostream>
+#include <random>
+
+namespace {
+constexpr size_t InitialRingCapacity = 16;
+
+uint32_t generateUdpToken() {
+    static std::mutex mutex;
+    static std::mt19937 generator{std::random_device{}()};
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<uint32_t>(generator());
+}
+}
+
+ClientConnection::ClientConnection(std::shared_ptr<boost::asio::ip::tcp::socket> socket, uint16_t playerId)
+    : socket_(std::move(socket)),
+      playerId_(playerId),
+      ring_(InitialRingCapacity),
+      udpToken_(generateUdpToken()) {
+}
+
+bool ClientConnection::send(Frame frame, FrameKind kind) {
+    if (!frame || closed_) {
+        return false;
+    }
+
+    bool startFlush = false;
+    bool overflow = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        size_t queued = queuedBytes_.load(std::memory_order_relaxed);
+        if (kind != FrameKind::Reliable) {
+            QueuedFrame* waiting = queuedStateFrame();
+            // A reliable frame in flight is usually the full state of a join or resync. It is
+            // large, and the client needs the deltas after it; dropping them while it is
+            // written would only flag the client for yet another full state.
+            if (kind == FrameKind::Heartbeat) {
+                // Anything already waiting says the server is alive just as well
+                if (waiting || queued > NetworkConfig::Server::ClientSendHighWaterBytes) {
+                    return false;
+                }
+            } else if (waiting && !reliableInFlight_) {
+                // The client is still busy with earlier state: keep only the latest
+                if (waiting->kind == FrameKind::State) {
+                    droppedStateFrames_.fetch_add(1, std::memory_order_relaxed);
+                    resyncNeeded_.store(true, std::memory_order_relaxed);
+                }
+                queuedBytes_.fetch_sub(waiting->frame->size(), std::memory_order_relaxed);
+                if (stateFramePosition_ + 1 == pushedFrames_) {
+                    // Nothing was queued after it, the new state can take its slot
+                    queuedBytes_.fetch_add(frame->size(), std::memory_order_relaxed);
+                    waiting->frame = std::move(frame);
+                    waiting->kind = kind;
+                    return true;  // The pending flush picks it up
+                }
+                // Reliable frames queued after the stale state must still arrive before the
+                // newer state, so the stale one is dropped and the new one goes to the end
+                queued -= waiting->frame->size();
+                waiting->frame.reset();  // Skipped by flush()
+            } else if (queued > NetworkConfig::Server::ClientSendHighWaterBytes && !reliableInFlight_) {
+                droppedStateFrames_.fetch_add(1, std::memory_order_relaxed);
+                resyncNeeded_.store(true, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        if (queued + frame->size() > NetworkConfig::Server::ClientSendBacklogLimitBytes) {
+            overflow = !overflowed_.exchange(true, std::memory_order_relaxed);
+        } else {
+            queuedBytes_.fetch_add(frame->size(), std::memory_order_relaxed);
+            pushFrame(std::move(frame), kind);
+            if (!writing_) {
+                writing_ = true;
+                startFlush = true;
+            }
+        }
+    }
+    if (overflow) {
+        std::cerr << "[ClientConnection] Client " << playerId_ << " has more than "
+                  << NetworkConfig::Server::ClientSendBacklogLimitBytes << " bytes queued, disconnecting" << std::endl;
+        close();
+    }
+    if (overflowed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    // Frames queued while a write is in flight go out with the next flush
+    if (startFlush) {
+        auto self = shared_from_this();
+        boost::asio::post(socket_->get_executor(), [self]() { self->flush(); });
+    }
+    return true;
+}
+
+void ClientConnection::close() {
+    if (closed_.exchange(true)) {
+        return;
+    }
+    auto self = shared_from_this();
+    boost::asio::post(socket_->get_executor(), [self]() {
+        boost::system::error_code ec;
+        self->socket_->cancel(ec);
+        self->socket_->close(ec);
+    });
+}
+
+bool ClientConnection::isOpen() const {
+    return !closed_ && socket_ && socket_->is_open();
+}
+
+void ClientConnection::setUdpEndpoint(const DatagramChannel::Endpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(udpMutex_);
+    udpEndpoint_ = endpoint;
+    udpEndpointBound_ = true;
+}
+
+bool ClientConnection::getUdpEndpoint(DatagramChannel::Endpoint& endpoint) const {
+    std::lock_guard<std::mutex> lock(udpMutex_);
+    endpoint = udpEndpoint_;
+    return udpEndpointBound_;
+}
+
+bool ClientConnection::activateUdp() {
+    std::lock_guard<std::mutex> lock(udpMutex_);
+    if (!udpEndpointBound_) {
+        return false;
+    }
+    udpActive_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool ClientConnection::acceptUdpSequence(uint32_t sequence) {
+    if (udpSequenceSeen_ && !DatagramChannel::isNewer(sequence, lastUdpSequence_)) {
+        return false;
+    }
+    udpSequenceSeen_ = true;
+    lastUdpSequence_ = sequence;
+    return true;
+}
+
+bool ClientConnection::takeResyncRequest() {
+    if (!resyncNeeded_.load(std::memory_order_relaxed) ||
+        getQueuedBytes() > NetworkConfig::Server::ClientSendLowWaterBytes) {
+        return false;
+    }
+    return resyncNeeded_.exchange(false, std::memory_order_relaxed);
+}
+
+void ClientConnection::flush() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        reliableInFlight_ = false;
+        while (ringCount_ > 0) {
+            QueuedFrame queued = popFrame();
+            if (!queued.frame) {
+                continue;  // Superseded state
+            }
+            reliableInFlight_ = reliableInFlight_ || queued.kind == FrameKind::Reliable;
+            inFlight_.push_back(std::move(queued.frame));
+        }
+    }
+    if (inFlight_.empty() || !socket_->is_open()) {
+        handleWrite(boost::asio::error::not_connected);
+        return;
+    }
+
+    gatherBuffers_.clear();
+    for (const auto& frame : inFlight_) {
+        gatherBuffers_.push_back(boost::asio::buffer(*frame));
+    }
+    auto self = shared_from_this();
+    boost::asio::async_write(*socket_, gatherBuffers_,
+        [self](const boost::system::error_code& error, std::size_t /*bytesTransferred*/) {
+            self->handleWrite(error);
+        });
+}
+
+void ClientConnection::handleWrite(const boost::system::error_code& error) {
+    size_t written = 0;
+    for (const auto& frame : inFlight_) {
+        written += frame->size();
+    }
+    inFlight_.clear();
+    queuedBytes_.fetch_sub(written, std::memory_order_relaxed);
+
+    if (error && error != boost::asio::error::not_connected) {
+        if (error != boost::asio::error::operation_aborted) {
+            std::cerr << "[ClientConnection] Error sending to client " << playerId_ << ": " << error.message() << std::endl;
+        }
+        // The read side notices the closed socket and reports the disconnect
+        boost::system::error_code ec;
+        socket_->close(ec);
+        closed_ = true;
+    }
+
+    bool more = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (closed_ || !socket_->is_open()) {
+            // Nothing will be written anymore, release whatever is still queued
+            size_t dropped = 0;
+            while (ringCount_ > 0) {
+                QueuedFrame queued = popFrame();
+                dropped += queued.frame ? queued.frame->size() : 0;
+            }
+            queuedBytes_.fetch_sub(dropped, std::memory_order_relaxed);
+        }
+        more = ringCount_ > 0;
+        writing_ = more;
+        reliableInFlight_ = false;
+    }
+    if (more) {
+        flush();
+    }
+}
+
+void ClientConnection::pushFrame(Frame frame, FrameKind kind) {
+    if (ringCount_ == ring_.size()) {
+        // Unroll into a ring twice the size
+        std::vector<QueuedFrame> grown(ring_.size() * 2);
+        for (size_t i = 0; i < ringCount_; ++i) {
+            grown[i] = std::move(ring_[(ringHead_ + i) % ring_.size()]);
+        }
+        ring_ = std::move(grown);
+        ringHead_ = 0;
+    }
+    ring_[(ringHead_ + ringCount_) % ring_.size()] = QueuedFrame{std::move(frame), kind};
+    ++ringCount_;
+    if (kind != FrameKind::Reliable) {
+        stateFramePosition_ = pushedFrames_;
+        stateFrameQueued_ = true;
+    }
+    ++pushedFrames_;
+}
+
+ClientConnection::QueuedFrame ClientConnection::popFrame() {
+    QueuedFrame queued = std::move(ring_[ringHead_]);
+    ringHead_ = (ringHead_ + 1) % ring_.size();
+    --ringCount_;
+    ++poppedFrames_;
+    return queued;
+}
+
+ClientConnection::QueuedFrame* ClientConnection::queuedStateFrame() {
+    if (!stateFrameQueued_ || stateFramePosition_ < poppedFrames_) {
+        stateFrameQueued_ = false;
+        return nullptr;
+    }
+    return &ring_[(ringHead_ + (stateFramePosition_ - poppedFrames_)) % ring_.size()];
+}
@@ -0,0 +1,130 @@
+#include "network/DatagramChannel.h"
+#include "network/NetworkConfig.h"
+#include <iostream>
+
+DatagramChannel::DatagramChannel(boost::asio::io_context& io_context)
+    : socket_(boost::asio::make_strand(io_context)),
+      receiveBuffer_(NetworkConfig::MaxDatagramSize) {
+}
+
+DatagramChannel::~DatagramChannel() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+bool DatagramChannel::open(const Endpoint& local) {
+    boost::system::error_code ec;
+    // Reopening drops the previous binding, its pending receive completes as aborted
+    socket_.close(ec);
+    socket_.open(local.protocol(), ec);
+    if (!ec) {
+        socket_.bind(local, ec);
+    }
+    if (ec) {
+        std::cerr << "[DatagramChannel] Failed to bind UDP port " << local.port() << ": " << ec.message() << std::endl;
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+        return false;
+    }
+    return true;
+}
+
+void DatagramChannel::close() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+bool DatagramChannel::isOpen() const {
+    return socket_.is_open();
+}
+
+uint16_t DatagramChannel::getLocalPort() const {
+    boost::system::error_code ec;
+    auto endpoint = socket_.local_endpoint(ec);
+    return ec ? 0 : endpoint.port();
+}
+
+void DatagramChannel::startReceive(ReceiveHandler handler) {
+    handler_ = std::move(handler);
+    boost::asio::dispatch(socket_.get_executor(), [this]() { receive(); });
+}
+
+void DatagramChannel::receive() {
+    if (!socket_.is_open()) {
+        return;
+    }
+    socket_.async_receive_from(boost::asio::buffer(receiveBuffer_), receiveFrom_,
+        [this](const boost::system::error_code& error, std::size_t size) {
+            if (error == boost::asio::error::operation_aborted || !socket_.is_open()) {
+                return;
+            }
+            // Errors like ICMP port unreachable only concern one peer, keep listening
+            if (!error && size >= HeaderSize) {
+                const uint8_t* d = receiveBuffer_.data();
+                uint32_t sequence = (static_cast<uint32_t>(d[0]) << 24) | (static_cast<uint32_t>(d[1]) << 16) |
+                                    (static_cast<uint32_t>(d[2]) << 8) | static_cast<uint32_t>(d[3]);
+                uint32_t dataSize = (static_cast<uint32_t>(d[7]) << 24) | (static_cast<uint32_t>(d[8]) << 16) |
+                                    (static_cast<uint32_t>(d[9]) << 8) | static_cast<uint32_t>(d[10]);
+                // Truncated or padded datagrams are dropped
+                if (dataSize == size - HeaderSize && handler_) {
+                    handler_(receiveFrom_, sequence, d + sizeof(uint32_t), size - sizeof(uint32_t));
+                }
+            }
+            receive();
+        });
+}
+
+void DatagramChannel::send(const Endpoint& to, Datagram datagram) {
+    if (!datagram) {
+        return;
+    }
+    boost::asio::post(socket_.get_executor(), [this, to, datagram]() {
+        if (!socket_.is_open()) {
+            return;
+        }
+        // The datagram keeps its buffer alive until the send completes
+        socket_.async_send_to(boost::asio::buffer(*datagram), to,
+            [datagram](const boost::system::error_code& /*error*/, std::size_t /*bytesTransferred*/) {
+                // Lost or refused datagrams are expected, the next one replaces them
+            });
+    });
+}
+
+DatagramChannel::Datagram DatagramChannel::encode(uint32_t sequence, const NetworkMessage& message) {
+    auto datagram = std::make_shared<std::vector<uint8_t>>();
+    datagram->reserve(HeaderSize + message.data.size());
+    beginEncode(*datagram, sequence, message.type, message.senderId);
+    datagram->insert(datagram->end(), message.data.begin(), message.data.end());
+    endEncode(*datagram);
+    return datagram;
+}
+
+void DatagramChannel::beginEncode(std::vector<uint8_t>& out, uint32_t sequence, MessageType type, uint16_t senderId) {
+    out.clear();
+
+    // 1. Sequence number - 4 bytes
+    out.push_back(static_cast<uint8_t>((sequence >> 24) & 0xFF));
+    out.push_back(static_cast<uint8_t>((sequence >> 16) & 0xFF));
+    out.push_back(static_cast<uint8_t>((sequence >> 8) & 0xFF));
+    out.push_back(static_cast<uint8_t>(sequence & 0xFF));
+
+    // 2. Message type - 1 byte
+    out.push_back(static_cast<uint8_t>(type));
+
+    // 3. Sender ID - 2 bytes
+    out.push_back(static_cast<uint8_t>((senderId >> 8) & 0xFF));
+    out.push_back(static_cast<uint8_t>(senderId & 0xFF));
+
+    // 4. Data length - 4 bytes, filled in by endEncode
+    out.resize(HeaderSize);
+}
+
+void DatagramChannel::endEncode(std::vector<uint8_t>& out) {
+    // 5. Data content follows the header
+    const uint32_t dataSize = static_cast<uint32_t>(out.size() - HeaderSize);
+    uint8_t* length = out.data() + HeaderSize - sizeof(uint32_t);
+    length[0] = static_cast<uint8_t>((dataSize >> 24) & 0xFF);
+    length[1] = static_cast<uint8_t>((dataSize >> 16) & 0xFF);
+    length[2] = static_cast<uint8_t>((dataSize >> 8) & 0xFF);
+    length[3] = static_cast<uint8_t>(dataSize & 0xFF);
+}
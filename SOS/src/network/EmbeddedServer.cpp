@@ -1,7 +1,9 @@
 #include <iostream>
 #include <chrono>
 #include <array>
+#include <algorithm>
 #include <future>
+#include <cstring>
 
 #include <boost/bind.hpp>
 
@@ -11,17 +13,32 @@
 #include "objects/player.h"
 #include "objects/tile.h"
 #include "player_manager.h"
+#include "utils/LzCodec.h"
+#include "network/SnapshotCodec.h"
+#include "network/WireSchema.h"
 
-// Buffer size for incoming messages
-constexpr size_t MAX_MESSAGE_SIZE = 1024;
+namespace {
+// [u32 body size][type u8][sender u16 BE][data length u32 BE] in front of the data of a frame
+constexpr size_t FrameHeaderSize = sizeof(MessageHeader) + 1 + sizeof(uint16_t) + sizeof(uint32_t);
+}
+
+// Receive state of one client connection, reused for every frame
+struct EmbeddedServer::ReadState {
+    MessageHeader header;
+    // Type, sender and data length; the data is read straight into the message data
+    std::array<uint8_t, 1 + sizeof(uint16_t) + sizeof(uint32_t)> messageHeader;
+};
 
-EmbeddedServer::EmbeddedServer(int port, const std::filesystem::path& basePath)
+EmbeddedServer::EmbeddedServer(int port, const std::filesystem::path& basePath, bool parallelLevelUpdate)
     : port_(port), 
       running_(false),
       gameLoopRunning_(false),
-      levelManager_(std::make_shared<LevelManager>(basePath)),
-      collisionManager_(std::make_shared<CollisionManager>()) {
+      levelManager_(std::make_shared<LevelManager>(basePath, parallelLevelUpdate)),
+      collisionManager_(std::make_shared<CollisionManager>()),
+      tickScheduler_(NetworkConfig::Server::TickRate, NetworkConfig::Server::MaxCatchUpTicks),
+      loadController_(tickScheduler_.getPeriod(), NetworkConfig::Server::StateUpdateInterval) {
     std::cout << "[EmbeddedServer] Created on port " << port << std::endl;
+    levelManager_->setProfiler(&tickProfiler_);
   
     
     // Initialize the acceptor but don't start listening until start() is called
@@ -39,31 +56,54 @@ void EmbeddedServer::start() {
     }
     
     try {
-        // Setup TCP acceptor
-        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port_);
-        std::cout << "[EmbeddedServer] Attempting to bind to port " << port_ << std::endl;
-        
-        acceptor_->open(endpoint.protocol());
-        acceptor_->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor_->bind(endpoint);
+        if (acceptConnections_) {
+            // Setup TCP acceptor
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port_);
+            std::cout << "[EmbeddedServer] Attempting to bind to port " << port_ << std::endl;
+            
+            acceptor_->open(endpoint.protocol());
+            acceptor_->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            acceptor_->bind(endpoint);
+            
+            std::cout << "[EmbeddedServer] Successfully bound to port " << port_ << std::endl;
+            acceptor_->listen();
+            std::cout << "[EmbeddedServer] Now listening on port " << port_ << std::endl;
+            
+            // Start accepting connections
+            startAccept();
+        } else {
+            std::cout << "[EmbeddedServer] Not listening, clients are handed over by the lobby" << std::endl;
+        }
         
-        std::cout << "[EmbeddedServer] Successfully bound to port " << port_ << std::endl;
-        acceptor_->listen();
-        std::cout << "[EmbeddedServer] Now listening on port " << port_ << std::endl;
+        // UDP side channel for snapshots and input, clients stay on TCP without it
+        udpChannel_ = std::make_unique<DatagramChannel>(io_context_);
+        if (udpChannel_->open({boost::asio::ip::udp::v4(), NetworkConfig::Server::UdpPort})) {
+            std::cout << "[EmbeddedServer] UDP side channel on port " << udpChannel_->getLocalPort() << std::endl;
+            udpChannel_->startReceive([this](const DatagramChannel::Endpoint& from, uint32_t sequence,
+                                             const uint8_t* body, size_t size) {
+                handleDatagram(from, sequence, body, size);
+            });
+        } else {
+            std::cerr << "[EmbeddedServer] Continuing without UDP side channel" << std::endl;
+            udpChannel_.reset();
+        }
         
-        // Start accepting connections
-        startAccept();
+        // Keep the io_context running while there is no pending accept
+        workGuard_ = std::make_unique<WorkGuard>(io_context_.get_executor());
         
-        // Start io_context in a separate thread
-        io_thread_ = std::make_unique<std::thread>([this]() {
-            try {
-                std::cout << "[EmbeddedServer] Network thread started" << std::endl;
-                io_context_.run();
-                std::cout << "[EmbeddedServer] Network thread stopped" << std::endl;
-            } catch (const std::exception& e) {
-                std::cerr << "[EmbeddedServer] Network thread error: " << e.what() << std::endl;
-            }
-        });
+        // Run io_context on a pool of network threads, each client is serialized by its own strand
+        std::cout << "[EmbeddedServer] Starting " << ioThreadCount_ << " network threads" << std::endl;
+        for (size_t i = 0; i < ioThreadCount_; ++i) {
+            ioThreads_.emplace_back([this]() {
+                try {
+                    std::cout << "[EmbeddedServer] Network thread started" << std::endl;
+                    io_context_.run();
+                    std::cout << "[EmbeddedServer] Network thread stopped" << std::endl;
+                } catch (const std::exception& e) {
+                    std::cerr << "[EmbeddedServer] Network thread error: " << e.what() << std::endl;
+                }
+            });
+        }
         
         running_ = true;
         std::cout << "[EmbeddedServer] Started" << std::endl;
@@ -71,10 +111,14 @@ void EmbeddedServer::start() {
         // Initialize game world with static objects
         createInitialGameObjects();
         
+        // Start the sender thread before the game loop publishes its first snapshot
+        senderRunning_ = true;
+        senderThread_ = std::make_unique<std::thread>([this]() {
+            senderLoop();
+        });
+        
         // Start game loop in a separate thread
         gameLoopRunning_ = true;
-        lastUpdateTime_ = std::chrono::high_resolution_clock::now();
-        
         gameLoopThread_ = std::make_unique<std::thread>([this]() {
             run();
         });
@@ -84,7 +128,9 @@ void EmbeddedServer::start() {
         if (acceptor_ && acceptor_->is_open()) {
             acceptor_->close();
         }
+        workGuard_.reset();
         io_context_.stop();
+        udpChannel_.reset();
         running_ = false;
     }
 }
@@ -124,10 +170,8 @@ void EmbeddedServer::stop() {
         std::lock_guard<std::mutex> lock(clientSocketsMutex_);
         for (auto& client : clientSockets_) {
             try {
-                if (client.second && client.second->is_open()) {
-                    boost::system::error_code ec;
-                    client.second->cancel(ec); // Cancel any pending async operations
-                    client.second->close(ec);
+                if (client.second) {
+                    client.second->close(); // Cancels pending reads and writes
                 }
             } catch (const std::exception& e) {
                 std::cerr << "[EmbeddedServer] Error closing client socket: " << e.what() << std::endl;
@@ -136,69 +180,24 @@ void EmbeddedServer::stop() {
         clientSockets_.clear();
         std::cout << "[EmbeddedServer] All client connections closed" << std::endl;
     }
+    // Release the game loop if it is parked waiting for clients
+    clientsChanged_.notify_all();
     
     // Cancel all pending operations and stop the io_context
+    workGuard_.reset();
     io_context_.stop();
     
-    // Join the io_thread with a simple timeout approach
-    if (io_thread_ && io_thread_->joinable()) {
-        
-        // Check if thread ID is valid and thread is actually running
-        std::thread::id thread_id = io_thread_->get_id();
-        
-        // Try a direct join first with short timeout
-        bool joined = false;
-        {
-            
-            try {
-                if (io_thread_->joinable()) {
-                    io_thread_->join();
-                    joined = true;
-                } else {
-                    std::cout << "[EmbeddedServer] IO thread not joinable (despite earlier check), skipping join" << std::endl;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "[EmbeddedServer] First join attempt failed with error: " << e.what() << std::endl;
-            }
-        }
-        
-        // If first attempt failed, try with timeout approach
-        if (!joined) {
-            std::cout << "[EmbeddedServer] First join attempt failed, trying with timeout approach" << std::endl;
-            
-            const auto timeout = std::chrono::seconds(3);
-            std::thread* thread_ptr = io_thread_.get();
-            auto start_time = std::chrono::steady_clock::now();
-            
-            // Only continue if thread is still joinable
-            if (!thread_ptr->joinable()) {
-                std::cout << "[EmbeddedServer] Thread no longer joinable after first attempt, skipping further join attempts" << std::endl;
-            } else {
-                while (thread_ptr->joinable()) {
-                    // Try to join with a small timeout to keep checking if we should give up
-                    if (std::chrono::steady_clock::now() - start_time > timeout) {
-                        thread_ptr->detach();  // Detach explicitly instead of leaking
-                        break; // Give up after timeout
-                    }
-                    
-                    // Try to join with a very short timeout
-                    try {
-                        // Thread is detached in destructor if not joined here
-                        if (thread_ptr->joinable()) {
-                            thread_ptr->join();
-                            // std::cout << "[EmbeddedServer] IO thread joined successfully" << std::endl;
-                        }
-                        break; // We joined successfully
-                    } catch (const std::exception& e) {
-                        std::cerr << "[EmbeddedServer] Error joining IO thread: " << e.what() << std::endl;
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    }
-                }
+    // Join the network threads
+    for (auto& ioThread : ioThreads_) {
+        try {
+            if (ioThread.joinable()) {
+                ioThread.join();
             }
+        } catch (const std::exception& e) {
+            std::cerr << "[EmbeddedServer] Error joining IO thread: " << e.what() << std::endl;
         }
-    } else {
-        std::cout << "[EmbeddedServer] IO thread is null or not joinable, skipping join" << std::endl;
     }
+    ioThreads_.clear();
     
     // Wait for game loop thread to finish with timeout
     if (gameLoopThread_ && gameLoopThread_->joinable()) {
@@ -259,35 +258,52 @@ void EmbeddedServer::stop() {
         std::cout << "[EmbeddedServer] Game loop thread is null or not joinable, skipping join" << std::endl;
     }
     
+    // The game loop no longer publishes, so the sender thread can be released
+    {
+        std::lock_guard<std::mutex> lock(senderMutex_);
+        senderRunning_ = false;
+    }
+    snapshotReady_.notify_all();
+    if (senderThread_ && senderThread_->joinable()) {
+        try {
+            senderThread_->join();
+        } catch (const std::exception& e) {
+            std::cerr << "[EmbeddedServer] Error joining sender thread: " << e.what() << std::endl;
+        }
+    }
+    
+    // Network and sender threads are gone, nothing uses the UDP socket anymore
+    udpChannel_.reset();
+    
     // Clear game state
     {
         std::lock_guard<std::mutex> lock(gameStateMutex_);
         // Clear game objects and players
-        levelManager_->removeAllPlayersFromCurrentLevel();
-        levelManager_->removeAllObjectsFromCurrentLevel();
+        levelManager_->clearLoadedLevels();
     }
     
     std::cout << "[EmbeddedServer] Stopped" << std::endl;
 }
 
-void EmbeddedServer::processMessage(const NetworkMessage& message) {
-    // Process based on message type
+void EmbeddedServer::processMessage(NetworkMessage message) {
+    // Called from the network thread. Anything that touches game state is queued
+    // and applied by the game loop at the start of the next tick.
     switch (message.type) {
         case MessageType::CONNECT: {
             std::cout << "[EmbeddedServer] Processing connect message from client" << std::endl;
-            uint16_t assignedPlayerId = message.senderId;
-            std::cout << "[EmbeddedServer] Assigned player ID: " << assignedPlayerId << std::endl;
-            std::shared_ptr<boost::asio::ip::tcp::socket> clientSocket;
+            bool known = false;
             {
                 std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-                auto it = clientSockets_.find(assignedPlayerId);
-                if (it != clientSockets_.end()) {
-                    clientSocket = it->second;
+                auto it = clientSockets_.find(message.senderId);
+                known = it != clientSockets_.end();
+                // Optional flags byte after the level id, see ConnectFlags
+                const auto& d = message.data;
+                if (known && !d.empty() && 1u + d[0] < d.size()) {
+                    it->second->setCompressedState((d[1 + d[0]] & ConnectFlags::CompressedState) != 0);
                 }
             }
-            if (clientSocket) {
-                addPlayer(assignedPlayerId);
-                sendFullGameStateToClient(assignedPlayerId);
+            if (known) {
+                inputQueue_.push(std::move(message));
             } else {
                 std::cerr << "[EmbeddedServer] Error: Failed to find assigned player ID for connecting client" << std::endl;
             }
@@ -296,25 +312,33 @@ void EmbeddedServer::processMessage(const NetworkMessage& message) {
             
         case MessageType::DISCONNECT:
             std::cout << "[EmbeddedServer] Processing disconnect message from " << message.senderId << std::endl;
-            // Remove the player from the game
-            removePlayer(message.senderId);
             // Remove the socket from the clientSockets_ map
             {
                 std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-                clientSockets_.erase(message.senderId);
+                auto it = clientSockets_.find(message.senderId);
+                if (it == clientSockets_.end()) {
+                    break; // Already handled (DISCONNECT message followed by socket close)
+                }
+                it->second->close();
+                clientSockets_.erase(it);
             }
+            // The player itself is removed by the game loop
+            inputQueue_.push(std::move(message));
             break;
             
         case MessageType::PLAYER_INPUT:
-            processPlayerInput(message.senderId, message);
-            break;
         case MessageType::PLAYER_POSITION:
-            processPlayerPosition(message.senderId, message);
-            break;
         case MessageType::ENEMY_STATE_UPDATE:
-            // Process player actions, including enemy state updates
-            processEnemyState(message.senderId, message);
+            inputQueue_.push(std::move(message));
             break;
+        case MessageType::UDP_READY: {
+            std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+            auto it = clientSockets_.find(message.senderId);
+            if (it != clientSockets_.end() && it->second->activateUdp()) {
+                std::cout << "[EmbeddedServer] Client " << message.senderId << " receives snapshots over UDP" << std::endl;
+            }
+            break;
+        }
         case MessageType::CHAT:
             // Just relay chat messages to all clients
             if (messageCallback_) {
@@ -328,10 +352,59 @@ void EmbeddedServer::processMessage(const NetworkMessage& message) {
     }
 }
 
+void EmbeddedServer::applyQueuedMessages() {
+    NetworkMessage message;
+    while (inputQueue_.tryPop(message)) {
+        try {
+            applyMessage(message);
+        } catch (const std::exception& e) {
+            std::cerr << "[EmbeddedServer] Error applying message of type " << static_cast<int>(message.type)
+                      << " from " << message.senderId << ": " << e.what() << std::endl;
+        }
+        receivePool_.release(std::move(message.data));
+    }
+}
+
+void EmbeddedServer::applyMessage(const NetworkMessage& message) {
+    switch (message.type) {
+        case MessageType::CONNECT: {
+            uint16_t assignedPlayerId = message.senderId;
+            std::cout << "[EmbeddedServer] Assigned player ID: " << assignedPlayerId << std::endl;
+            // Optional payload: [u8 length][level id] selects the level to join
+            std::string levelId;
+            if (!message.data.empty()) {
+                size_t len = message.data[0];
+                if (1 + len <= message.data.size()) {
+                    levelId.assign(message.data.begin() + 1, message.data.begin() + 1 + len);
+                }
+            }
+            addPlayer(assignedPlayerId, levelId);
+            // Captured with the next snapshot and sent by the sender thread
+            pendingFullStates_.push_back(assignedPlayerId);
+            break;
+        }
+        case MessageType::DISCONNECT:
+            // Remove the player from the game
+            removePlayer(message.senderId);
+            break;
+        case MessageType::PLAYER_INPUT:
+            processPlayerInput(message.senderId, message);
+            break;
+        case MessageType::PLAYER_POSITION:
+            processPlayerPosition(message.senderId, message);
+            break;
+        case MessageType::ENEMY_STATE_UPDATE:
+            // Process player actions, including enemy state updates
+            processEnemyState(message.senderId, message);
+            break;
+        default:
+            break;
+    }
+}
+
 
 void EmbeddedServer::removePlayer(const uint16_t playerId) {
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
-    auto& pm = PlayerManager::getInstance();
+    auto& pm = levelManager_->getPlayerManager();
     auto playerIt = pm.getPlayer(playerId);
     if (playerIt == nullptr) {
         std::cerr << "[EmbeddedServer] Player " << playerId << " not found" << std::endl;
@@ -340,8 +413,8 @@ void EmbeddedServer::removePlayer(const uint16_t playerId) {
     
     std::cout << "[EmbeddedServer] Removing player " << playerId << std::endl;
     
-    // Remove player from game objects
-    //auto player = playerIt;
+    // Remove player from its level and the session's manager
+    levelManager_->removePlayer(playerId);
     pm.removePlayer(playerId);
     //auto objIt = std::find(gameObjects_.begin(), gameObjects_.end(), player);
     // if (objIt != gameObjects_.end()) {
@@ -363,22 +436,21 @@ void EmbeddedServer::removePlayer(const uint16_t playerId) {
 
 
 void EmbeddedServer::startAccept() {
-    // Create a new socket for the incoming connection
-    auto socket = std::make_shared<boost::asio::ip::tcp::socket>(io_context_);
-    
-    // Set up an asynchronous accept operation to wait for a new connection
-    acceptor_->async_accept(*socket,
-        [this, socket](const boost::system::error_code& error) {
-            handleAccept(error, socket);
+    // Every accepted socket gets its own strand, so its handlers never run concurrently
+    acceptor_->async_accept(boost::asio::make_strand(io_context_),
+        [this](const boost::system::error_code& error, boost::asio::ip::tcp::socket socket) {
+            handleAccept(error, std::make_shared<boost::asio::ip::tcp::socket>(std::move(socket)));
         });
 }
 
 void EmbeddedServer::handleAccept(const boost::system::error_code& error, 
                                   std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
     if (!error) {
+        boost::system::error_code ec;
+        auto endpoint = socket->remote_endpoint(ec);
         std::cout << "[EmbeddedServer] New client connected: " 
-                  << socket->remote_endpoint().address().to_string() << ":"
-                  << socket->remote_endpoint().port() << std::endl;
+                  << endpoint.address().to_string() << ":"
+                  << endpoint.port() << std::endl;
         
         // Handle the connection in a separate function
         handleClientConnection(socket);
@@ -392,227 +464,251 @@ void EmbeddedServer::handleAccept(const boost::system::error_code& error,
     }
 }
 
+bool EmbeddedServer::adoptClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
+    if (!running_ || !socket || !socket->is_open()) {
+        return false;
+    }
+    handleClientConnection(socket);
+    return true;
+}
+
+boost::asio::io_context& EmbeddedServer::getIoContext() {
+    return io_context_;
+}
+
+size_t EmbeddedServer::getClientCount() {
+    std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+    return clientSockets_.size();
+}
+
 void EmbeddedServer::handleClientConnection(std::shared_ptr<boost::asio::ip::tcp::socket> socket) {
-    // Generate a unique player ID for this client (now using uint16_t)
-    uint16_t generatedPlayerId = Object::getNextObjectID();
-    std::cout << "[EmbeddedServer] New connection from: "
-              << socket->remote_endpoint().address().to_string() << ":"
-              << socket->remote_endpoint().port() << std::endl;
+    // Players are objects of the session, their ID comes from the same allocator
+    uint16_t generatedPlayerId = levelManager_->getObjectIds().next();
     std::cout << "[EmbeddedServer] Generated player ID: " << generatedPlayerId << std::endl;
+    auto connection = std::make_shared<ClientConnection>(socket, generatedPlayerId);
     {
         std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-        clientSockets_[generatedPlayerId] = socket;
+        clientSockets_[generatedPlayerId] = connection;
         std::cout << "[EmbeddedServer] Added client socket for player ID: " << generatedPlayerId << std::endl;
     }
-    // Start the proper async read sequence to get a complete message
-    auto headerBuffer = std::make_shared<std::array<char, sizeof(MessageHeader)>>();
+    // Wake the game loop if it is parked
+    clientsChanged_.notify_one();
+    offerUdpChannel(connection);
+    // Reads run on the socket's strand; the player ID travels with the read chain
+    boost::asio::dispatch(socket->get_executor(), [this, socket, generatedPlayerId]() {
+        handleRead(socket, generatedPlayerId, std::make_shared<ReadState>());
+    });
+}
+
+void EmbeddedServer::handleRead(std::shared_ptr<boost::asio::ip::tcp::socket> socket, uint16_t playerId,
+                                std::shared_ptr<ReadState> state) {
     boost::asio::async_read(*socket, 
-        boost::asio::buffer(*headerBuffer, sizeof(MessageHeader)),
-        [this, socket, headerBuffer, generatedPlayerId](const boost::system::error_code& error, std::size_t bytes_transferred) {
-            if (!error && bytes_transferred == sizeof(MessageHeader)) {
-                MessageHeader* header = reinterpret_cast<MessageHeader*>(headerBuffer->data());
-                uint32_t headerSize = header->size;
-                std::cout << "[EmbeddedServer] Received message header with size: " << header->size << " bytes" << std::endl;
-                if (header->size > MAX_MESSAGE_SIZE) {
-                    std::cerr << "[EmbeddedServer] Message size exceeds maximum limit" << std::endl;
-                    boost::system::error_code ec;
-                    socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-                    socket->close(ec);
-                    return;
-                }
-                std::cout << "[EmbeddedServer] Valid header size, proceeding to read message body..." << std::endl;
-                auto bodyBuffer = std::make_shared<std::array<char, MAX_MESSAGE_SIZE>>();
-                boost::asio::async_read(*socket,
-                    boost::asio::buffer(bodyBuffer->data(), header->size),
-                    [this, socket, bodyBuffer, headerSize, generatedPlayerId](const boost::system::error_code& error, std::size_t bytes_transferred) {
-                        std::cout << "[EmbeddedServer] Received message body with size: " << bytes_transferred << " bytes" << std::endl;
-                        std::cout << "[EmbeddedServer] Header size: " << headerSize << std::endl;
-                        if (!error && bytes_transferred == headerSize) {
-                            std::vector<uint8_t> messageData(
-                                bodyBuffer->data(),
-                                bodyBuffer->data() + headerSize
-                            );
-                            std::cout << "Deserializing from sender ID: " << generatedPlayerId << std::endl;
-                            NetworkMessage message = deserializeMessage(messageData, generatedPlayerId);
-                            std::cout << "[EmbeddedServer] Received first message from client - Type: " << static_cast<int>(message.type)
-                                     << " from " << message.senderId << " with data size: " << message.data.size() << " bytes" << std::endl;
-                            if (!message.data.empty()) {
-                                try {
-                                    std::string playerInfo(message.data.begin(), message.data.end());
-                                    std::cout << "[EmbeddedServer] Message data: " << playerInfo << std::endl;
-                                } catch (const std::exception& e) {
-                                    std::cerr << "[EmbeddedServer] Error extracting message data: " << e.what() << std::endl;
-                                }
-                            }
-                            message.senderId = generatedPlayerId; // Set the sender ID to the generated player ID
-                            processMessage(message);
-                            std::cout << "[EmbeddedServer] First message processed, now waiting for more messages..." << std::endl;
-                            handleRead(socket, boost::system::error_code(), 0);
-                        } else {
-                            if (error) {
-                                std::cerr << "[EmbeddedServer] Error reading message body: " << error.message() << std::endl;
-                            }
-                        }
-                    });
-            } else {
-                if (error) {
-                    std::cerr << "[EmbeddedServer] Error reading initial message header: " << error.message() << std::endl;
-                }
+        boost::asio::buffer(&state->header, sizeof(MessageHeader)),
+        [this, socket, playerId, state](const boost::system::error_code& error, std::size_t bytes_transferred) {
+            if (error || bytes_transferred != sizeof(MessageHeader)) {
+                handleReadError(playerId, error);
+                return;
             }
+            const uint32_t bodySize = state->header.size;
+            if (bodySize < state->messageHeader.size() || bodySize > NetworkConfig::MaxClientFrameSize) {
+                std::cerr << "[EmbeddedServer] Invalid message size " << bodySize << " from client " << playerId << std::endl;
+                boost::system::error_code ec;
+                socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+                socket->close(ec);
+                handleReadError(playerId, boost::asio::error::message_size);
+                return;
+            }
+            // The payload buffer grows to the frame size and becomes the message data as is.
+            // Moving the vector into the handler keeps its storage where the read writes to.
+            BufferPool::Buffer payload = receivePool_.acquire(bodySize - state->messageHeader.size());
+            std::array<boost::asio::mutable_buffer, 2> buffers = {
+                boost::asio::buffer(state->messageHeader),
+                boost::asio::buffer(payload),
+            };
+            boost::asio::async_read(*socket, buffers,
+                [this, socket, playerId, state, bodySize, payload = std::move(payload)]
+                (const boost::system::error_code& error, std::size_t bytes_transferred) mutable {
+                    if (error || bytes_transferred != bodySize) {
+                        receivePool_.release(std::move(payload));
+                        handleReadError(playerId, error);
+                        return;
+                    }
+                    const uint8_t* h = state->messageHeader.data();
+                    const uint32_t dataSize = (static_cast<uint32_t>(h[3]) << 24) | (static_cast<uint32_t>(h[4]) << 16) |
+                                              (static_cast<uint32_t>(h[5]) << 8) | static_cast<uint32_t>(h[6]);
+                    if (dataSize != payload.size()) {
+                        std::cerr << "[EmbeddedServer] Data length " << dataSize << " does not match frame from client "
+                                  << playerId << ", dropping message" << std::endl;
+                        receivePool_.release(std::move(payload));
+                        handleRead(socket, playerId, state);
+                        return;
+                    }
+                    NetworkMessage message;
+                    message.type = static_cast<MessageType>(h[0]);
+                    message.senderId = playerId; // The connection decides who sent it
+                    message.targetId = 0;
+                    message.data = std::move(payload);
+                    processMessage(std::move(message));
+                    handleRead(socket, playerId, state);
+                });
         });
 }
 
-void EmbeddedServer::handleRead(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
-                               const boost::system::error_code& error,
-                               size_t bytes_transferred) {
-    if (!error) {
-        uint16_t playerId = 0;
-        try {
-            // Find the playerId by matching the socket in clientSockets_
+void EmbeddedServer::handleReadError(uint16_t playerId, const boost::system::error_code& error) {
+    // Aborted reads while running mean the server closed the connection itself (e.g. backlog overflow)
+    if (error == boost::asio::error::operation_aborted && !running_) {
+        return; // Server is shutting down
+    }
+    if (error && error != boost::asio::error::eof && error != boost::asio::error::connection_reset) {
+        std::cerr << "[EmbeddedServer] Read error from client " << playerId << ": " << error.message() << std::endl;
+    }
+    std::cout << "[EmbeddedServer] Client disconnected: " << playerId << std::endl;
+    NetworkMessage disconnectMsg;
+    disconnectMsg.type = MessageType::DISCONNECT;
+    disconnectMsg.senderId = playerId;
+    processMessage(disconnectMsg);
+}
+
+void EmbeddedServer::offerUdpChannel(const std::shared_ptr<ClientConnection>& connection) {
+    if (!udpChannel_) {
+        return;
+    }
+    const uint16_t udpPort = udpChannel_->getLocalPort();
+    const uint32_t token = connection->getUdpToken();
+    NetworkMessage offer;
+    offer.type = MessageType::UDP_OFFER;
+    offer.senderId = 0;
+    offer.targetId = connection->getPlayerId();
+    offer.data = {
+        static_cast<uint8_t>(udpPort >> 8), static_cast<uint8_t>(udpPort & 0xFF),
+        static_cast<uint8_t>(token >> 24), static_cast<uint8_t>((token >> 16) & 0xFF),
+        static_cast<uint8_t>((token >> 8) & 0xFF), static_cast<uint8_t>(token & 0xFF),
+    };
+    sendToClient(connection, offer);
+}
+
+void EmbeddedServer::handleDatagram(const DatagramChannel::Endpoint& from, uint32_t sequence,
+                                    const uint8_t* body, size_t size) {
+    // Body: [type u8][sender u16 BE][data length u32 BE][data]
+    constexpr size_t dataOffset = 1 + sizeof(uint16_t) + sizeof(uint32_t);
+    const auto type = static_cast<MessageType>(body[0]);
+    
+    if (type == MessageType::UDP_HELLO) {
+        if (size < dataOffset + sizeof(uint32_t)) {
+            return;
+        }
+        const uint8_t* d = body + dataOffset;
+        uint32_t token = (static_cast<uint32_t>(d[0]) << 24) | (static_cast<uint32_t>(d[1]) << 16) |
+                         (static_cast<uint32_t>(d[2]) << 8) | static_cast<uint32_t>(d[3]);
+        std::shared_ptr<ClientConnection> connection;
+        {
             std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-            for (const auto& entry : clientSockets_) {
-                if (entry.second == socket) {
-                    playerId = entry.first;
+            for (const auto& [id, candidate] : clientSockets_) {
+                if (candidate->getUdpToken() == token) {
+                    connection = candidate;
                     break;
                 }
             }
-        } catch (const std::exception& e) {
-            std::cerr << "[EmbeddedServer] Error getting player ID: " << e.what() << std::endl;
+        }
+        if (!connection) {
             return;
         }
-        auto buffer = std::make_shared<std::array<char, MAX_MESSAGE_SIZE>>();
-        boost::asio::async_read(*socket, 
-            boost::asio::buffer(buffer->data(), sizeof(MessageHeader)),
-            [this, socket, buffer, playerId](const boost::system::error_code& error, std::size_t bytes_transferred) {
-                if (!error && bytes_transferred == sizeof(MessageHeader)) {
-                    MessageHeader* header = reinterpret_cast<MessageHeader*>(buffer->data());
-                    boost::asio::async_read(*socket,
-                        boost::asio::buffer(buffer->data() + sizeof(MessageHeader), header->size),
-                        [this, socket, buffer, header, playerId](const boost::system::error_code& error, std::size_t bytes_transferred) {
-                            if (!error && bytes_transferred == header->size) {
-                                std::vector<uint8_t> messageData(
-                                    buffer->data() + sizeof(MessageHeader),
-                                    buffer->data() + sizeof(MessageHeader) + header->size
-                                );
-                                NetworkMessage message = deserializeMessage(messageData, playerId);
-                                processMessage(message);
-                                handleRead(socket, boost::system::error_code(), 0);
-                            } else {
-                                if (error) {
-                                    std::cerr << "[EmbeddedServer] Error reading message body: " << error.message() << std::endl;
-                                }
-                            }
-                        });
-                } else {
-                    if (error && error != boost::asio::error::operation_aborted) {
-                        std::cerr << "[EmbeddedServer] Error reading message header: " << error.message() << std::endl;
-                    }
-                }
-            });
-    } else if (error == boost::asio::error::eof || 
-              error == boost::asio::error::connection_reset) {
-        uint16_t playerId = 0;
-        try {
-            std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-            for (const auto& entry : clientSockets_) {
-                if (entry.second == socket) {
-                    playerId = entry.first;
-                    break;
-                }
+        connection->setUdpEndpoint(from);
+        
+        // Echo the token so the client knows datagrams reach it as well
+        NetworkMessage echo;
+        echo.type = MessageType::UDP_HELLO;
+        echo.senderId = 0;
+        echo.targetId = connection->getPlayerId();
+        echo.data.assign(d, d + sizeof(uint32_t));
+        udpChannel_->send(from, DatagramChannel::encode(0, echo));
+        return;
+    }
+    
+    // Only state that a newer datagram fully replaces may arrive over UDP
+    if (type != MessageType::PLAYER_INPUT && type != MessageType::PLAYER_POSITION) {
+        return;
+    }
+    std::shared_ptr<ClientConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+        for (const auto& [id, candidate] : clientSockets_) {
+            DatagramChannel::Endpoint endpoint;
+            if (candidate->getUdpEndpoint(endpoint) && endpoint == from) {
+                connection = candidate;
+                break;
             }
-            std::cout << "[EmbeddedServer] Client disconnected: " << playerId << std::endl;
-            clientSockets_.erase(playerId);
-            NetworkMessage disconnectMsg;
-            disconnectMsg.type = MessageType::DISCONNECT;
-            disconnectMsg.senderId = playerId;
-            processMessage(disconnectMsg);
-        } catch (const std::exception& e) {
-            std::cerr << "[EmbeddedServer] Error handling disconnection: " << e.what() << std::endl;
         }
-    } else {
-        std::cerr << "[EmbeddedServer] Read error: " << error.message() << std::endl;
     }
+    // Unknown sender, or older than input we already have
+    if (!connection || !connection->acceptUdpSequence(sequence)) {
+        return;
+    }
+    processMessage(deserializeMessage(body, size, connection->getPlayerId()));
 }
 
-bool EmbeddedServer::sendToClient(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
-                                 const NetworkMessage& message) 
-{
-    try {
-        // Create a shared_ptr to manage the message buffer lifetime
-        auto buffer_ptr = std::make_shared<std::vector<uint8_t>>();
-        auto& buffer = *buffer_ptr;
-        
-        // 1. Message type - 1 byte
-        buffer.push_back(static_cast<uint8_t>(message.type));
-        
-        // 2/. Sender ID - 2 bytes
-        buffer.push_back(static_cast<uint8_t>((message.senderId >> 8) & 0xFF));
-        buffer.push_back(static_cast<uint8_t>(message.senderId & 0xFF));
+ClientConnection::Frame EmbeddedServer::encodeFrame(const NetworkMessage& message, FramePool* pool) {
+    // [u32 body size][type u8][sender u16 BE][data length u32 BE][data], built in one buffer
+    const size_t frameSize = FrameHeaderSize + message.data.size();
+    auto frame = pool ? pool->acquire(frameSize) : std::make_shared<std::vector<uint8_t>>();
+    frame->reserve(frameSize);
+    beginFrame(*frame, message.type, message.senderId);
+    frame->insert(frame->end(), message.data.begin(), message.data.end());
+    endFrame(*frame);
+    return frame;
+}
 
+void EmbeddedServer::beginFrame(std::vector<uint8_t>& frame, MessageType type, uint16_t senderId) {
+    // Body size prefix, filled in by endFrame
+    frame.assign(sizeof(MessageHeader), 0);
+    
+    // 1. Message type - 1 byte
+    frame.push_back(static_cast<uint8_t>(type));
+    
+    // 2. Sender ID - 2 bytes
+    frame.push_back(static_cast<uint8_t>((senderId >> 8) & 0xFF));
+    frame.push_back(static_cast<uint8_t>(senderId & 0xFF));
+    
+    // 3. Data length - 4 bytes, filled in by endFrame
+    frame.resize(frame.size() + sizeof(uint32_t));
+}
 
-        // 3. Data length - 4 bytes (important!)
-        uint32_t dataSize = static_cast<uint32_t>(message.data.size());
-        buffer.push_back(static_cast<uint8_t>((dataSize >> 24) & 0xFF));
-        buffer.push_back(static_cast<uint8_t>((dataSize >> 16) & 0xFF));
-        buffer.push_back(static_cast<uint8_t>((dataSize >> 8) & 0xFF));
-        buffer.push_back(static_cast<uint8_t>(dataSize & 0xFF));
-        
-        // 4. Data content
-        buffer.insert(buffer.end(), message.data.begin(), message.data.end());
-        
-        // Create the complete message with header + body
-        std::vector<uint8_t> completeMessage;
-        
-        // Set the header size field to the size of the buffer (which is the message body)
-        MessageHeader header;
-        header.size = static_cast<uint32_t>(buffer.size());
-        
-        // Create a shared_ptr for the complete message
-        auto complete_message_ptr = std::make_shared<std::vector<uint8_t>>();
-        auto& complete_message = *complete_message_ptr;
-        complete_message.resize(sizeof(header) + buffer.size());
-        
-        // Copy the header
-        std::memcpy(complete_message.data(), &header, sizeof(header));
+void EmbeddedServer::endFrame(std::vector<uint8_t>& frame) {
+    MessageHeader header;
+    header.size = static_cast<uint32_t>(frame.size() - sizeof(header));
+    std::memcpy(frame.data(), &header, sizeof(header));
+    
+    // 4. Data content follows the header
+    const uint32_t dataSize = static_cast<uint32_t>(frame.size() - FrameHeaderSize);
+    uint8_t* length = frame.data() + FrameHeaderSize - sizeof(uint32_t);
+    length[0] = static_cast<uint8_t>((dataSize >> 24) & 0xFF);
+    length[1] = static_cast<uint8_t>((dataSize >> 16) & 0xFF);
+    length[2] = static_cast<uint8_t>((dataSize >> 8) & 0xFF);
+    length[3] = static_cast<uint8_t>(dataSize & 0xFF);
+}
 
-        // Add the message body after the header
-        std::memcpy(complete_message.data() + sizeof(header), buffer.data(), buffer.size());
+bool EmbeddedServer::sendToClient(const std::shared_ptr<ClientConnection>& connection,
+                                 const NetworkMessage& message, OutboundBundler* bundler) 
+{
+    try {
+        ClientConnection::Frame frame = encodeFrame(message, bundler ? bundler->framePool() : nullptr);
         
-        if(message.type == MessageType::GAME_STATE)
+        if(message.type == MessageType::GAME_STATE || message.type == MessageType::GAME_STATE_COMPRESSED)
         {
             std::cout << "[EmbeddedServer] Sending message to client - Type: " 
                       << static_cast<int>(message.type) 
                       << ", Sender ID: " << message.senderId 
                       << ", Data size: " << message.data.size() 
-                      << " bytes, Total size: " << complete_message.size() 
+                      << " bytes, Total size: " << frame->size() 
                       << " bytes" << std::endl;
         }
 
-        // Store the buffer to keep it alive
-        {
-            std::lock_guard<std::mutex> lock(outgoing_buffers_mutex_);
-            outgoing_buffers_.push_back(complete_message_ptr);
+        if (bundler) {
+            bundler->add(connection, frame, ClientConnection::FrameKind::Reliable);
+            return true;
         }
-
-        // Send the message asynchronously
-        boost::asio::async_write(*socket,
-            boost::asio::buffer(complete_message),
-            [this, complete_message_ptr](const boost::system::error_code& error, std::size_t bytes_transferred) {
-                // Clean up the buffer only after the operation completes
-                {
-                    std::lock_guard<std::mutex> lock(outgoing_buffers_mutex_);
-                    outgoing_buffers_.erase(
-                        std::remove(outgoing_buffers_.begin(), outgoing_buffers_.end(), complete_message_ptr),
-                        outgoing_buffers_.end());
-                }
-                
-                if (error) {
-                    std::cerr << "[EmbeddedServer] Error sending to client" 
-                              << ": " << error.message() << std::endl;
-                    
-                }
-            });
-        return true;
+        // Queued on the connection, which coalesces it with other pending frames
+        return connection->send(std::move(frame));
     } catch (const std::exception& e) {
         std::cerr << "[EmbeddedServer] Error sending message to client: " << e.what() << std::endl;
      return false;
@@ -620,63 +716,150 @@ bool EmbeddedServer::sendToClient(std::shared_ptr<boost::asio::ip::tcp::socket>
     
 }
 
+size_t EmbeddedServer::getQueuedOutboundBytes() {
+    size_t total = 0;
+    std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+    for (const auto& [id, connection] : clientSockets_) {
+        total += connection->getQueuedBytes();
+    }
+    return total;
+}
+
 void EmbeddedServer::run() {
     std::cout << "[EmbeddedServer] Game loop started" << std::endl;
     
-    const float fixedDeltaSeconds = 1.0 / NetworkConfig::Server::TickRate;
+    const float fixedDeltaSeconds = tickScheduler_.getFixedDeltaSeconds();
     std::cout << "[EmbeddedServer] Fixed delta time: " << fixedDeltaSeconds << " seconds" << std::endl;
-    const uint64_t fixedDeltaMilliseconds = static_cast<uint64_t>(fixedDeltaSeconds * 1000);
-    unsigned int loopCounter = 0;
+    const auto statsInterval = std::chrono::seconds(NetworkConfig::Server::TickStatsReportInterval);
+    auto lastStatsReport = TickScheduler::Clock::now();
 
+    tickScheduler_.reset();
     while (gameLoopRunning_) {
-        auto before = std::chrono::high_resolution_clock::now();
+        // Without clients there is nothing to simulate, park until someone connects
+        if (waitWhileIdle()) {
+            if (!gameLoopRunning_) {
+                break;
+            }
+            // Resync so the idle time is not caught up as a burst of ticks
+            tickScheduler_.reset();
+            loadController_.reset();
+        }
+
+        // Sleeps until the absolute deadline of the next tick; returns immediately when catching up
+        tickScheduler_.waitForNextTick();
+
+        auto tickStart = TickScheduler::Clock::now();
         try {
             updateGameState(fixedDeltaSeconds); // Always use fixed delta
         }
         catch (const std::exception& e) {
             std::cerr << "[EmbeddedServer] Exception in game update: " << e.what() << std::endl;
         }
+        // Everything the tick built in its arena has been sent or copied by now
+        tickArena_.reset();
+        // Sheds or restores load before the loop starts missing deadlines
+        loadController_.recordTick(TickScheduler::Clock::now() - tickStart, getQueuedOutboundBytes());
+        tickScheduler_.endTick();
+        tickProfiler_.endTick();
         
         // Check flag again before sleeping to respond faster to shutdown requests
         if (!gameLoopRunning_) {
             std::cout << "[EmbeddedServer] Game loop flag set to false, exiting loop" << std::endl;
             break;
         }
-        
-        auto after = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(after - before).count();
-        // Sleep until next tick
-        try {
-            std::this_thread::sleep_for(std::chrono::milliseconds(fixedDeltaMilliseconds- static_cast<uint64_t>(duration / 1000)));
-        }
-        catch (const std::exception& e) {
-            std::cerr << "[EmbeddedServer] Exception during game loop sleep: " << e.what() << std::endl;
-            std::this_thread::yield();
+
+        auto now = TickScheduler::Clock::now();
+        if (now - lastStatsReport >= statsInterval) {
+            lastStatsReport = now;
+            auto stats = tickScheduler_.getStats();
+            std::cout << "[EmbeddedServer] Tick rate: " << stats.measuredTickRate << " Hz, overruns: "
+                      << stats.overruns << ", skipped ticks: " << stats.skippedTicks << std::endl;
+            auto load = loadController_.getMetrics();
+            std::cout << "[EmbeddedServer] Load level: " << load.level << ", snapshot interval: " << load.snapshotIntervalMs
+                      << " ms, distant stride: " << load.distantUpdateStride << ", tick utilization: "
+                      << load.tickUtilization << " (peak " << load.peakTickUtilization << "), outbound: "
+                      << load.outboundBytes << " bytes, escalations: " << load.escalations
+                      << ", recoveries: " << load.recoveries << std::endl;
+            for (size_t i = 0; i < static_cast<size_t>(TickPhase::Count); ++i) {
+                auto phase = static_cast<TickPhase>(i);
+                auto phaseStats = tickProfiler_.getPhaseStats(phase);
+                if (phaseStats.samples == 0) continue;
+                std::cout << "[EmbeddedServer]   " << TickProfiler::phaseName(phase)
+                          << ": p50 " << phaseStats.p50Micros << " us, p99 " << phaseStats.p99Micros
+                          << " us, max " << phaseStats.maxMicros << " us" << std::endl;
+            }
         }
     }
 
-    std::cout << "[EmbeddedServer] Game loop stopped after " << loopCounter << " iterations" << std::endl;
+    std::cout << "[EmbeddedServer] Game loop stopped after " << tickScheduler_.getStats().ticks << " iterations" << std::endl;
+}
+
+bool EmbeddedServer::waitWhileIdle() {
+    std::unique_lock<std::mutex> lock(clientSocketsMutex_);
+    if (!clientSockets_.empty() || !gameLoopRunning_) {
+        return false;
+    }
+    lock.unlock();
+    // Leaves that arrived since the last tick are applied before parking
+    applyQueuedMessages();
+    tickBundler_.flush();
+    lock.lock();
+    
+    std::cout << "[EmbeddedServer] No clients connected, game loop idle" << std::endl;
+    clientsChanged_.wait(lock, [this]() { return !clientSockets_.empty() || !gameLoopRunning_; });
+    if (gameLoopRunning_) {
+        std::cout << "[EmbeddedServer] Client connected, game loop resuming" << std::endl;
+    }
+    return true;
 }
 
 bool EmbeddedServer::isRunning() const {
     return running_;
 }
 
-void EmbeddedServer::addPlayer(const uint16_t playerId) {
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
-    
-    // 1) Create (or fetch) the player in the global manager:
-    auto& pm = PlayerManager::getInstance();
+void EmbeddedServer::setIoThreadCount(size_t count) {
+    if (running_) {
+        std::cerr << "[EmbeddedServer] IO thread count can only be changed before start()" << std::endl;
+        return;
+    }
+    ioThreadCount_ = count > 0 ? count : 1;
+}
+
+void EmbeddedServer::setAcceptConnections(bool accept) {
+    if (running_) {
+        std::cerr << "[EmbeddedServer] Accepting connections can only be changed before start()" << std::endl;
+        return;
+    }
+    acceptConnections_ = accept;
+}
+
+TickScheduler::Stats EmbeddedServer::getTickStats() const {
+    return tickScheduler_.getStats();
+}
+
+const TickProfiler& EmbeddedServer::getTickProfiler() const {
+    return tickProfiler_;
+}
+
+LoadController::Metrics EmbeddedServer::getLoadMetrics() const {
+    return loadController_.getMetrics();
+}
+
+void EmbeddedServer::addPlayer(const uint16_t playerId, const std::string& levelId) {
+    // 1) Create (or fetch) the player in the session's manager:
+    auto& pm = levelManager_->getPlayerManager();
     
     std::shared_ptr<Player> player;
     if (pm.getPlayer(playerId) != nullptr) {
         std::cout << "[EmbeddedServer] Player " << playerId << " already exists, using existing player" << std::endl;
         player = pm.getPlayer(playerId);
     } else {
-        // Create a new player using the PlayerManager singleton
+        // Create a new player in the session's PlayerManager
         player = pm.createPlayer(playerId, Vec2{100, 100});
         std::cout << "[EmbeddedServer] Created new player " << playerId << std::endl;
-        levelManager_->addPlayerToCurrentLevel(playerId);
+        if (levelId.empty() || !levelManager_->addPlayerToLevel(playerId, levelId)) {
+            levelManager_->addPlayerToCurrentLevel(playerId);
+        }
     }
     
     // Send the player to the client
@@ -690,15 +873,10 @@ void EmbeddedServer::addPlayer(const uint16_t playerId) {
     // Serialize player data
     serializeObject(player, joinMsg.data);
 
-    // Broadcast joinMsg to all clients, except the one that just joined
-    {
-        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-        for (const auto& client : clientSockets_) {
-            if (client.first != playerId && client.second && client.second->is_open()) {
-                sendToClient(client.second, joinMsg);
-            }
-        }
-    }
+    // Broadcast joinMsg to the other clients in the same level
+    auto recipients = clientsInLevel(levelManager_->getLevelForPlayer(playerId), &tickArena_);
+    recipients.erase(std::remove(recipients.begin(), recipients.end(), playerId), recipients.end());
+    broadcastToClients(joinMsg, recipients, &tickBundler_);
 
     if (messageCallback_) {
         messageCallback_(joinMsg);
@@ -722,8 +900,8 @@ void EmbeddedServer::sendPlayerToClient(const uint16_t playerId, Player* player)
     playerMsg.data = std::move(data);
     std::lock_guard<std::mutex> lock(clientSocketsMutex_);
     auto it = clientSockets_.find(playerId);
-    if (it != clientSockets_.end() && it->second && it->second->is_open()) {
-        sendToClient(it->second, playerMsg);
+    if (it != clientSockets_.end() && it->second && it->second->isOpen()) {
+        sendToClient(it->second, playerMsg, &tickBundler_);
     }
 }
 
@@ -745,482 +923,464 @@ void EmbeddedServer::createInitialGameObjects() {
 }
 
 void EmbeddedServer::updateGameState(float deltaTime) {
+    // Joins, leaves and player input queued by the network thread
+    applyQueuedMessages();
+
     {
-        std::lock_guard<std::mutex> lock(gameStateMutex_);
+        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
         if(clientSockets_.empty()) {
-            // Print once every 5 seconds if no clients are connected
-            static auto last = std::chrono::steady_clock::now();
-            auto now = std::chrono::steady_clock::now();
-            if (now - last > std::chrono::seconds(5)) {
-                last = now;
-                std::cout << "[EmbeddedServer] No clients connected, skipping game update" << std::endl;
-            }
-            return; // nothing to update if no clients are connected
+            tickBundler_.flush();
+            return; // Last client left during this tick, run() parks before the next one
         }
+    }
+    TickProfiler::ScopedPhase tickPhase(&tickProfiler_, TickPhase::Tick);
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::LevelUpdate);
+        levelManager_->setDistantUpdateStride(loadController_.getDistantUpdateStride());
         levelManager_->update(deltaTime);
-        // Update all players
-        
-
     }
-    // Send game state to clients periodically
-    static float updateTimer = 0;
-    updateTimer += deltaTime;
+    // Everything this tick sent goes out as one bundle per client, ahead of the snapshot
+    tickBundler_.flush();
+    // Publish game state for the sender thread periodically
+    stateUpdateTimer_ += deltaTime;
     
-    if (updateTimer*1000 >= NetworkConfig::Server::StateUpdateInterval) {
-        updateTimer = 0;
-        sendGameStateToClients();
+    if (stateUpdateTimer_*1000 >= loadController_.getSnapshotIntervalMs()) {
+        stateUpdateTimer_ = 0;
+        publishSnapshot();
     }
 }
 
-void EmbeddedServer::sendGameStateToClients() {
-    // Get objects from the active level
-    Level* lvl = levelManager_->getCurrentLevel();
-
-    if (!lvl) {
-        return; // nothing to send if no level loaded
+void EmbeddedServer::publishSnapshot() {
+    TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::Snapshot);
+    
+    WorldSnapshot& snapshot = snapshots_.writeBuffer();
+    if (snapshotDropped_) {
+        // The sender never saw this buffer, its changes go back to their levels
+        // and its full states back to the pending ones for the next snapshot
+        for (size_t i = 0; i < snapshot.levelCount; ++i) {
+            const LevelSnapshot& dropped = snapshot.levels[i];
+            if (Level* level = levelManager_->getLevel(dropped.levelId)) {
+                for (const ObjectSnapshot& obj : dropped.changed) {
+                    level->getDirtyTracker().mark(obj.id);
+                }
+            }
+            for (uint16_t id : dropped.fullStateRecipients) {
+                if (std::find(pendingFullStates_.begin(), pendingFullStates_.end(), id) == pendingFullStates_.end()) {
+                    pendingFullStates_.push_back(id);
+                }
+            }
+        }
     }
-    auto objects = lvl->getObjects();
-
-    // Track which objects to send
-    std::vector<std::shared_ptr<Object>> objectsToSend = collectObjectsToSend(objects);
+    updatePendingFullStates();
     
-    // If we're just sending a heartbeat, no need to continue
-    if (objectsToSend.empty()) {
-        // std::cout << "[EmbeddedServer] No objects to send, sending minimal heartbeat" << std::endl;
-        return;
+    snapshot.tick = ++snapshotTick_;
+    snapshot.levelCount = 0;
+    for (const auto& level : levelManager_->getActiveLevels()) {
+        auto recipients = clientsInLevel(level.get(), &tickArena_);
+        // Nobody is playing this level
+        if (recipients.empty()) {
+            continue;
+        }
+        // Pending full states of this level's players are captured with it
+        ClientIds fullStateClients(&tickArena_);
+        auto it = pendingFullStates_.begin();
+        while (it != pendingFullStates_.end()) {
+            if (std::find(recipients.begin(), recipients.end(), *it) != recipients.end()) {
+                fullStateClients.push_back(*it);
+                it = pendingFullStates_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // The moving objects are only copied for clients on the UDP side channel
+        bool needDynamic = false;
+        if (udpChannel_) {
+            std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+            for (uint16_t id : recipients) {
+                auto socket = clientSockets_.find(id);
+                if (socket != clientSockets_.end() && socket->second->isUdpActive()) {
+                    needDynamic = true;
+                    break;
+                }
+            }
+        }
+        // Level snapshots are reused between publishes to keep their allocations
+        if (snapshot.levelCount == snapshot.levels.size()) {
+            snapshot.levels.emplace_back();
+        }
+        snapshot.levels[snapshot.levelCount++].capture(*level, recipients, fullStateClients, needDynamic);
     }
-
-    // Calculate total message size to determine if we need to split
-    size_t estimatedSize = calculateMessageSize(objectsToSend);
+    snapshotDropped_ = snapshots_.publish();
     
-    // Check if we need to split the message into multiple packets
-    if (estimatedSize > MAX_GAMESTATE_PACKET_SIZE) {
-        sendSplitGameState(objectsToSend, estimatedSize);
-    } else {
-        sendSingleGameStatePacket(objectsToSend);
+    {
+        std::lock_guard<std::mutex> lock(senderMutex_);
+        snapshotPending_ = true;
     }
+    snapshotReady_.notify_one();
 }
 
-std::vector<std::shared_ptr<Object>> EmbeddedServer::collectObjectsToSend(const std::vector<std::shared_ptr<Object>>& allObjects) {
-    std::vector<std::shared_ptr<Object>> objectsToSend;
-    
-    {
-        std::lock_guard<std::mutex> lock(gameStateMutex_);
-        
-        // Check if we have previous state to compare against
-        if (deltaTracker_.getAllObjectIds().empty()) {
-            // First time or after reset - send everything
-            objectsToSend = allObjects;
-            
-            // Update the tracker with the current objects
-            deltaTracker_.updateState(allObjects);
-        } else {
-            // Get only changed objects for delta update
-            objectsToSend = deltaTracker_.getChangedObjects(allObjects);
-            
-            // If there are no changes, still send a minimal update (heartbeat)
-            if (objectsToSend.empty()) {
-                sendMinimalHeartbeat();
-                return objectsToSend; // Return empty vector
+void EmbeddedServer::senderLoop() {
+    std::cout << "[EmbeddedServer] Sender thread started" << std::endl;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(senderMutex_);
+            snapshotReady_.wait(lock, [this]() { return snapshotPending_ || !senderRunning_; });
+            if (!senderRunning_) {
+                break;
             }
-            
-            // Update the tracker with all current objects
-            deltaTracker_.updateState(allObjects);
+            snapshotPending_ = false;
         }
+        if (!snapshots_.update()) {
+            continue;
+        }
+        
+        const WorldSnapshot& snapshot = snapshots_.readBuffer();
+        try {
+            serveFullStateRequests(snapshot);
+            sendGameStateToClients(snapshot);
+            snapshotBundler_.flush();
+        } catch (const std::exception& e) {
+            std::cerr << "[EmbeddedServer] Exception sending snapshot " << snapshot.tick << ": " << e.what() << std::endl;
+        }
+        snapshotArena_.reset();
+        tickProfiler_.commitSenderPass();
     }
-    
-    return objectsToSend;
+    std::cout << "[EmbeddedServer] Sender thread stopped" << std::endl;
 }
 
-void EmbeddedServer::sendMinimalHeartbeat() {
-    // Send a minimal update with just packet type
-    NetworkMessage minimalMsg;
-    minimalMsg.type = MessageType::GAME_STATE_DELTA;
-    minimalMsg.senderId = 0; // 'server' as 0 or a reserved value
-    minimalMsg.data = {0, 0}; // 0 objects
-    
-    // Send to all clients
-    std::lock_guard<std::mutex> lockSockets(clientSocketsMutex_);
-    if (clientSockets_.empty()) {
-        return;
+void EmbeddedServer::updatePendingFullStates() {
+    std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+    // Clients that had state dropped get the full state once their backlog drained
+    for (const auto& [id, connection] : clientSockets_) {
+        if (connection->takeResyncRequest() &&
+            std::find(pendingFullStates_.begin(), pendingFullStates_.end(), id) == pendingFullStates_.end()) {
+            std::cout << "[EmbeddedServer] Client " << id << " fell behind (" << connection->getDroppedStateFrames()
+                      << " state updates dropped so far), resending full game state" << std::endl;
+            pendingFullStates_.push_back(id);
+        }
     }
     
-    for (auto& [id, sock] : clientSockets_) {
-        if (sock && sock->is_open()) {
-            sendToClient(sock, minimalMsg);
+    // Keep waiting unless the client left before its level showed up in a snapshot
+    auto it = pendingFullStates_.begin();
+    while (it != pendingFullStates_.end()) {
+        if (clientSockets_.count(*it) == 0) {
+            std::cerr << "[EmbeddedServer] No active level for full game state sync" << std::endl;
+            it = pendingFullStates_.erase(it);
+        } else {
+            ++it;
         }
     }
-    
-    // Also notify through callback
-    if (messageCallback_) {
-        messageCallback_(minimalMsg);
+}
+
+void EmbeddedServer::serveFullStateRequests(const WorldSnapshot& snapshot) {
+    for (size_t i = 0; i < snapshot.levelCount; ++i) {
+        const LevelSnapshot& level = snapshot.levels[i];
+        for (uint16_t playerId : level.fullStateRecipients) {
+            sendFullGameStateToClient(level, playerId);
+        }
     }
 }
 
-size_t EmbeddedServer::calculateMessageSize(const std::vector<std::shared_ptr<Object>>& objectsToSend) {
-    size_t estimatedSize = 2; // Object count (2 bytes)
-    
-    for (const auto& obj : objectsToSend) {
-        if (!obj) continue;
-        
-        // Basic object data
-        size_t objSize = 1 + sizeof(uint16_t) + 16; // Type + ID (uint16_t) + position/velocity
-        
-        // Type-specific data
-        switch (obj->type) {
-            case ObjectType::PLAYER:
-            case ObjectType::MINOTAUR:
-                objSize += 4; // Animation state and direction, health
-                break;
-            case ObjectType::TILE: {
-                std::shared_ptr<Tile> tile = std::static_pointer_cast<Tile>(obj);
-                objSize += 5; // Tile index (1) + flags (4) + tilemapname length + tilemapname
-                objSize += 1 + tile->gettileMapName().size();
-                break;
+void EmbeddedServer::sendGameStateToClients(const WorldSnapshot& snapshot) {
+    for (size_t i = 0; i < snapshot.levelCount; ++i) {
+        const LevelSnapshot& level = snapshot.levels[i];
+
+        // Clients on the UDP side channel get the moving objects as datagrams
+        ClientIds tcpRecipients(&snapshotArena_);
+        ClientIds udpRecipients(&snapshotArena_);
+        std::pmr::vector<DatagramChannel::Endpoint> udpEndpoints(&snapshotArena_);
+        {
+            std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+            for (uint16_t id : level.recipients) {
+                auto it = clientSockets_.find(id);
+                DatagramChannel::Endpoint endpoint;
+                if (level.dynamicCaptured && udpChannel_ && it != clientSockets_.end() && it->second->isUdpActive() &&
+                    it->second->getUdpEndpoint(endpoint)) {
+                    udpRecipients.push_back(id);
+                    udpEndpoints.push_back(endpoint);
+                } else {
+                    tcpRecipients.push_back(id);
+                }
             }
-            default:
-                break;
         }
+
+        // Track which objects to send
+        ObjectSnapshotRefs objectsToSend(&snapshotArena_);
+        const bool heartbeat = collectObjectsToSend(level, objectsToSend);
         
-        estimatedSize += objSize;
+        if (!tcpRecipients.empty()) {
+            if (heartbeat) {
+                sendMinimalHeartbeat(tcpRecipients);
+            } else {
+                sendDeltaOverTcp(objectsToSend, tcpRecipients);
+            }
+        }
+        if (!udpRecipients.empty()) {
+            sendUdpSnapshot(level, static_cast<uint32_t>(snapshot.tick), udpEndpoints);
+            // Tile changes are rare and must not be lost, they stay on TCP
+            ObjectSnapshotRefs changedTiles(&snapshotArena_);
+            for (const ObjectSnapshot* obj : objectsToSend) {
+                if (static_cast<ObjectType>(obj->type) == ObjectType::TILE) {
+                    changedTiles.push_back(obj);
+                }
+            }
+            if (!changedTiles.empty()) {
+                sendDeltaOverTcp(changedTiles, udpRecipients);
+            }
+        }
     }
-    
-    return estimatedSize;
 }
 
-void EmbeddedServer::sendSplitGameState(const std::vector<std::shared_ptr<Object>>& objectsToSend, size_t estimatedSize) {
-    std::cout << "[EmbeddedServer] Game state too large, estimated size: " 
-              << estimatedSize << " bytes, splitting into packets" << std::endl;
-    std::cout << "[EmbeddedServer] Actual size: " 
-              << objectsToSend.size() << " objects to send" << std::endl;
-    // We need to split the message
-    size_t objectsPerPacket = MAX_GAMESTATE_PACKET_SIZE / (estimatedSize / objectsToSend.size()) - 15;
-    std::cout << "[EmbeddedServer] Estimated objects per packet: " 
-              << objectsPerPacket << std::endl;
-    size_t totalObjects = objectsToSend.size();
-    size_t packetCount = (totalObjects + objectsPerPacket - 1) / objectsPerPacket;
-    
-    std::cout << "[EmbeddedServer] Splitting game state update into " << packetCount 
-              << " packets with ~" << objectsPerPacket << " objects per packet" << std::endl;
-    
-    // Send packets
-    for (size_t i = 0; i < packetCount; i++) {
-        size_t startIndex = i * objectsPerPacket;
-        size_t count = std::min(objectsPerPacket, totalObjects - startIndex);
-        
-        bool isFirstPacket = (i == 0);
-        bool isLastPacket = (i == packetCount - 1);
-        
-        sendPartialGameState(objectsToSend, startIndex, count, isFirstPacket, isLastPacket);
+void EmbeddedServer::sendDeltaOverTcp(const ObjectSnapshotRefs& objectsToSend, const ClientIds& recipients) {
+    if (objectsToSend.empty()) {
+        return;
     }
-}
 
-void EmbeddedServer::sendSingleGameStatePacket(const std::vector<std::shared_ptr<Object>>& objectsToSend) {
-    // Message fits in a single packet - use delta state message
-    NetworkMessage stateMsg;
-    stateMsg.type = MessageType::GAME_STATE_DELTA;
-    stateMsg.senderId = 0; // 'server' as 0 or a reserved value
-    stateMsg.data.clear();
-    
-    // Serialize object count (2 bytes)
-    uint16_t count = static_cast<uint16_t>(objectsToSend.size());
-    stateMsg.data.push_back(uint8_t(count >> 8));
-    stateMsg.data.push_back(uint8_t(count & 0xFF));
-    
-    // std::cout << "[EmbeddedServer] Sending game state update with " 
-    //           << count << " objects in a single packet" << std::endl;
+    // Frames have no practical size limit, large deltas go out in one message as well
+    sendSingleGameStatePacket(objectsToSend, recipients);
+}
 
-    // Serialize each object
-    for (auto& obj : objectsToSend) {
-        // std::cout << "[EmbeddedServer] Serializing object of type " 
-        //           << static_cast<int>(obj->type) << " with ID: " 
-        //           << obj->getObjID() << std::endl;
-        serializeObject(obj, stateMsg.data);
-    }
-    
-    // Broadcast to all clients
+void EmbeddedServer::sendUdpSnapshot(const LevelSnapshot& level, uint32_t sequence,
+                                     const std::pmr::vector<DatagramChannel::Endpoint>& endpoints) {
+    // Each datagram is a complete GAME_STATE_DELTA for the objects it holds, so the
+    // client applies whichever arrive and a lost one is replaced by the next snapshot
+    std::pmr::vector<DatagramChannel::Datagram> datagrams(&snapshotArena_);
     {
-        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-        if (clientSockets_.empty()) {
-            static auto last = std::chrono::steady_clock::now();
-            auto now = std::chrono::steady_clock::now();
-            if (now - last > std::chrono::seconds(5)) {
-                last = now;
-                std::cout << "[EmbeddedServer] No clients connected, skipping update\n";
-            }
-            return;
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::Serialization);
+        
+        ObjectSnapshotRefs moving(&snapshotArena_);
+        moving.reserve(level.dynamic.size());
+        for (const ObjectSnapshot& obj : level.dynamic) {
+            moving.push_back(&obj);
         }
+        // All parts share one quantization frame, so each is sized before it is written
+        const SnapshotCodec::Frame frame = SnapshotCodec::frameFor(moving.data(), moving.size());
+        const size_t budgetBits = (NetworkConfig::MaxDatagramSize - DatagramChannel::HeaderSize) * 8;
         
-        for (auto& [id, sock] : clientSockets_) {
-            if (sock && sock->is_open()) {
-                sendToClient(sock, stateMsg);
+        size_t first = 0;
+        size_t objectBits = 0;
+        
+        auto flush = [&](size_t end) {
+            auto datagram = snapshotFrames_.acquire(NetworkConfig::MaxDatagramSize);
+            DatagramChannel::beginEncode(*datagram, sequence, MessageType::GAME_STATE_DELTA, 0);
+            SnapshotCodec::encode(moving.data() + first, end - first, frame, *datagram);
+            DatagramChannel::endEncode(*datagram);
+            datagrams.push_back(std::move(datagram));
+            first = end;
+            objectBits = 0;
+        };
+        
+        for (size_t i = 0; i < moving.size(); ++i) {
+            const size_t bits = SnapshotCodec::objectBits(*moving[i], frame);
+            const size_t count = i - first;
+            if (count > 0 && SnapshotCodec::headerBits(count + 1, frame) + objectBits + bits + 7 > budgetBits) {
+                flush(i);
             }
+            objectBits += bits;
+        }
+        // An empty datagram still advances the sequence and keeps NAT mappings open
+        if (first < moving.size() || datagrams.empty()) {
+            flush(moving.size());
         }
     }
     
-    // Fire callback if needed
-    if (messageCallback_) {
-        messageCallback_(stateMsg);
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::SocketFanout);
+        for (const auto& datagram : datagrams) {
+            for (const auto& endpoint : endpoints) {
+                udpChannel_->send(endpoint, datagram);
+            }
+        }
     }
 }
 
-/**
- * Sends a partial game state update to all clients.
- * This is used when the game state is too large to fit in a single packet.
- * Each part will contain metadata to indicate if it's the first or last part.
- */
-void EmbeddedServer::sendPartialGameState(
-    const std::vector<std::shared_ptr<Object>>& objects, 
-    size_t startIndex, size_t count, 
-    bool isFirstPacket, bool isLastPacket) {
-    
-    // Create a new message for this part
-    NetworkMessage partMsg;
-    partMsg.type = MessageType::GAME_STATE_PART;
-    partMsg.senderId = 0; // 'server' as 0 or a reserved value
-    partMsg.data.clear();
-    
-    // Packet metadata (3 bytes):
-    // - First byte: isFirstPacket (0x01) | isLastPacket (0x02)
-    // - Second and third bytes: Total object count
-    uint8_t flags = (isFirstPacket ? 0x01 : 0x00) | (isLastPacket ? 0x02 : 0x00);
-    partMsg.data.push_back(flags);
-    
-    uint16_t totalCount = static_cast<uint16_t>(objects.size());
-    partMsg.data.push_back(uint8_t(totalCount >> 8));
-    partMsg.data.push_back(uint8_t(totalCount & 0xFF));
-    
-    // Packet specific data (2 bytes):
-    // - Start index (2 bytes)
-    partMsg.data.push_back(uint8_t(startIndex >> 8));
-    partMsg.data.push_back(uint8_t(startIndex & 0xFF));
+bool EmbeddedServer::collectObjectsToSend(const LevelSnapshot& level, ObjectSnapshotRefs& objectsToSend) {
+    TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::CollectObjects);
     
-    // - Object count in this packet (2 bytes)
-    partMsg.data.push_back(uint8_t(count >> 8));
-    partMsg.data.push_back(uint8_t(count & 0xFF));
-    
-    std::cout << "Serializing " << count << " objects starting from index " 
-              << startIndex << " of total " << objects.size() << " objects." << std::endl;
-    // Serialize each object in this range
-    for (size_t i = startIndex; i < startIndex + count && i < objects.size(); i++) {
-        // if(i > PRINTNUM)
-        // {
-        //     std::cout << "[EmbeddedServer] Serializing object " << i << " of type " 
-        //             << static_cast<int>(objects[i]->type) << "and ID: " << objects[i]->getObjID() << std::endl;
-        // }
-        serializeObject(objects[i], partMsg.data);
+    // The level's dirty tracker already narrowed them down, no comparison against older state
+    objectsToSend.reserve(level.changed.size());
+    for (const ObjectSnapshot& obj : level.changed) {
+        objectsToSend.push_back(&obj);
     }
     
-    // Broadcast to all clients
-    {
-        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-        if (clientSockets_.empty()) {
-            return;
+    // The heartbeat is sent by the caller so it is not timed as collection, but only
+    // in the case it always was: a level with objects of which none changed
+    return objectsToSend.empty() && level.objectCount > 0;
+}
+
+ClientIds EmbeddedServer::clientsInLevel(const Level* level, std::pmr::memory_resource* memory) {
+    ClientIds recipients(memory);
+    if (!level) {
+        return recipients;
+    }
+    std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+    for (const auto& [id, sock] : clientSockets_) {
+        if (levelManager_->getLevelForPlayer(id) == level) {
+            recipients.push_back(id);
         }
-        
-        for (auto& [id, sock] : clientSockets_) {
-            if (sock && sock->is_open()) {
-                // std::cout << "[EmbeddedServer] Sending partial game state to client " 
-                //           << id << " - Part: " << (isFirstPacket ? "First" : "Middle") 
-                //           << ", Count: " << count << std::endl;
-                sendToClient(sock, partMsg);
+    }
+    return recipients;
+}
+
+void EmbeddedServer::broadcastToClients(const NetworkMessage& message, const ClientIds& recipients,
+                                        OutboundBundler* bundler, ClientConnection::FrameKind kind) {
+    if (recipients.empty()) {
+        return;
+    }
+    // Every client receives the same bytes, so the message is framed once
+    broadcastFrame(encodeFrame(message, bundler ? bundler->framePool() : nullptr), recipients, bundler, kind);
+}
+
+void EmbeddedServer::broadcastFrame(const ClientConnection::Frame& frame, const ClientIds& recipients,
+                                    OutboundBundler* bundler, ClientConnection::FrameKind kind) {
+    std::lock_guard<std::mutex> lock(clientSocketsMutex_);
+    for (uint16_t id : recipients) {
+        auto it = clientSockets_.find(id);
+        if (it != clientSockets_.end() && it->second && it->second->isOpen()) {
+            if (bundler) {
+                bundler->add(it->second, frame, kind);
+            } else {
+                it->second->send(frame, kind);
             }
         }
     }
-    
-    // Fire callback if needed
-    if (messageCallback_) {
-        messageCallback_(partMsg);
-    }
 }
 
-void EmbeddedServer::sendPartialGameStateToClient(
-    const std::vector<std::shared_ptr<Object>>& objects, 
-    size_t startIndex, size_t count, 
-    bool isFirstPacket, bool isLastPacket,
-    uint16_t playerId) {
-    NetworkMessage partMsg;
-    partMsg.type = MessageType::GAME_STATE_PART;
-    partMsg.senderId = 0;
-    partMsg.targetId = playerId;
-    partMsg.data.clear();
-    
-    // Packet metadata (3 bytes):
-    // - First byte: isFirstPacket (0x01) | isLastPacket (0x02)
-    // - Second and third bytes: Total object count
-    uint8_t flags = (isFirstPacket ? 0x01 : 0x00) | (isLastPacket ? 0x02 : 0x00);
-    partMsg.data.push_back(flags);
-    
-    uint16_t totalCount = static_cast<uint16_t>(objects.size());
-    partMsg.data.push_back(uint8_t(totalCount >> 8));
-    partMsg.data.push_back(uint8_t(totalCount & 0xFF));
+void EmbeddedServer::sendMinimalHeartbeat(const ClientIds& recipients) {
+    // Send a minimal update with just packet type, the frame never changes
+    static const NetworkMessage minimalMsg = []() {
+        NetworkMessage msg;
+        msg.type = MessageType::GAME_STATE_DELTA;
+        msg.senderId = 0; // 'server' as 0 or a reserved value
+        msg.targetId = 0;
+        msg.data = {0}; // 0 objects
+        return msg;
+    }();
+    static const ClientConnection::Frame minimalFrame = encodeFrame(minimalMsg);
     
-    // Packet specific data (4 bytes):
-    // - Start index (2 bytes)
-    partMsg.data.push_back(uint8_t(startIndex >> 8));
-    partMsg.data.push_back(uint8_t(startIndex & 0xFF));
-    
-    // - Object count in this packet (2 bytes)
-    partMsg.data.push_back(uint8_t(count >> 8));
-    partMsg.data.push_back(uint8_t(count & 0xFF));
-    for (size_t i = startIndex; i < startIndex + count && i < objects.size(); ++i) {
-        serializeObject(objects[i], partMsg.data);
+    // Send to the clients in the level
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::SocketFanout);
+        broadcastFrame(minimalFrame, recipients, &snapshotBundler_, ClientConnection::FrameKind::Heartbeat);
     }
-    std::lock_guard<std::mutex> sockLock(clientSocketsMutex_);
-    auto it = clientSockets_.find(playerId);
-    if (it != clientSockets_.end() && it->second && it->second->is_open()) {
-        std::cout << "[EmbeddedServer] Sending partial game state to client " 
-                  << playerId << " - Part: " << (isFirstPacket ? "First" : (isLastPacket ? "Last" : "Middle")) 
-                  << ", byte size: " << partMsg.data.size()
-                  << ", objects: " << count << std::endl;
-        sendToClient(it->second, partMsg);
-    } else {
-        std::cerr << "[EmbeddedServer] Could not send partial game state to client: " << playerId << std::endl;
+    
+    // Also notify through callback
+    if (messageCallback_) {
+        messageCallback_(minimalMsg);
     }
 }
 
-void EmbeddedServer::sendSplitGameStateToClient(
-    const std::vector<std::shared_ptr<Object>>& objectsToSend, 
-    size_t estimatedSize, 
-    uint16_t playerId) {
-    size_t objectsPerPacket = MAX_GAMESTATE_PACKET_SIZE / (estimatedSize / objectsToSend.size()) - 25;
-    size_t totalObjects = objectsToSend.size();
-    size_t packetCount = (totalObjects + objectsPerPacket - 1) / objectsPerPacket;
-    std::cout << "[EmbeddedServer] Splitting game state for client " << playerId
-              << " into " << packetCount << " packets with ~" << objectsPerPacket 
-              << " objects per packet (total objects: " << totalObjects << ")" << std::endl;
-    for (size_t i = 0; i < packetCount; i++) {
-        size_t startIndex = i * objectsPerPacket;
-        size_t count = std::min(objectsPerPacket, totalObjects - startIndex);
-        bool isFirstPacket = (i == 0);
-        bool isLastPacket = (i == packetCount - 1);
-        sendPartialGameStateToClient(objectsToSend, startIndex, count, isFirstPacket, isLastPacket, playerId);
-        if(!isLastPacket)
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+void EmbeddedServer::sendSingleGameStatePacket(const ObjectSnapshotRefs& objectsToSend, const ClientIds& recipients) {
+    // The payload is packed straight into the pooled frame every recipient shares
+    auto frame = snapshotFrames_.acquire(0);
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::Serialization);
+        beginFrame(*frame, MessageType::GAME_STATE_DELTA, 0); // 'server' as 0 or a reserved value
+        SnapshotCodec::encode(objectsToSend, *frame);
+        endFrame(*frame);
+    }
+    
+    // Broadcast to the clients in the level
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::SocketFanout);
+        broadcastFrame(frame, recipients, &snapshotBundler_, ClientConnection::FrameKind::State);
+    }
+    
+    // Fire callback if needed, only then is the payload copied into a message
+    if (messageCallback_) {
+        NetworkMessage stateMsg;
+        stateMsg.type = MessageType::GAME_STATE_DELTA;
+        stateMsg.senderId = 0;
+        stateMsg.targetId = 0;
+        stateMsg.data.assign(frame->begin() + FrameHeaderSize, frame->end());
+        messageCallback_(stateMsg);
     }
 }
 
 void EmbeddedServer::sendSingleGameStatePacketToClient(
-    const std::vector<std::shared_ptr<Object>>& objectsToSend, 
+    const ObjectSnapshotRefs& objectsToSend,
+    const std::vector<std::string>& tilesetNames,
     uint16_t playerId) {
     std::vector<uint8_t> data;
-    uint16_t objectCount = static_cast<uint16_t>(objectsToSend.size());
-    data.push_back(static_cast<uint8_t>(objectCount >> 8));
-    data.push_back(static_cast<uint8_t>(objectCount & 0xFF));
-    for (const auto& obj : objectsToSend) {
-        serializeObject(obj, data);
+    {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::Serialization);
+        SnapshotCodec::encode(objectsToSend, data);
     }
     NetworkMessage msg;
     msg.type = MessageType::GAME_STATE;
     msg.senderId = 0;
     msg.targetId = playerId;
-    msg.data = std::move(data);
-    std::lock_guard<std::mutex> sockLock(clientSocketsMutex_);
-    auto it = clientSockets_.find(playerId);
-    if (it != clientSockets_.end() && it->second && it->second->is_open()) {
-        sendToClient(it->second, msg);
+
+    // Only the lookup holds the lock, the game loop and IO threads take it every tick
+    std::shared_ptr<ClientConnection> connection;
+    {
+        std::lock_guard<std::mutex> sockLock(clientSocketsMutex_);
+        auto it = clientSockets_.find(playerId);
+        if (it != clientSockets_.end()) {
+            connection = it->second;
+        }
+    }
+    if (!connection || !connection->isOpen()) {
+        return;
+    }
+
+    // Queued on the same bundler, so the table always arrives before the state
+    NetworkMessage tableMsg;
+    tableMsg.type = MessageType::TILESET_TABLE;
+    tableMsg.senderId = 0;
+    tableMsg.targetId = playerId;
+    tableMsg.data = WireSchema::encodeTilesetTable(tilesetNames);
+    sendToClient(connection, tableMsg, &snapshotBundler_);
+
+    // The level's tiles make the join state large but very repetitive
+    if (connection->acceptsCompressedState() && data.size() >= NetworkConfig::Server::CompressStateMinBytes) {
+        TickProfiler::ScopedPhase phase(&tickProfiler_, TickPhase::Serialization);
+        std::vector<uint8_t> compressed;
+        LzCodec::compress(data.data(), data.size(), compressed);
+        if (compressed.size() + sizeof(uint32_t) < data.size()) {
+            const uint32_t originalSize = static_cast<uint32_t>(data.size());
+            msg.type = MessageType::GAME_STATE_COMPRESSED;
+            msg.data.reserve(sizeof(uint32_t) + compressed.size());
+            msg.data.push_back(static_cast<uint8_t>((originalSize >> 24) & 0xFF));
+            msg.data.push_back(static_cast<uint8_t>((originalSize >> 16) & 0xFF));
+            msg.data.push_back(static_cast<uint8_t>((originalSize >> 8) & 0xFF));
+            msg.data.push_back(static_cast<uint8_t>(originalSize & 0xFF));
+            msg.data.insert(msg.data.end(), compressed.begin(), compressed.end());
+        }
     }
+    if (msg.type == MessageType::GAME_STATE) {
+        msg.data = std::move(data);
+    }
+    if (!connection->isOpen()) {
+        return;
+    }
+    sendToClient(connection, msg, &snapshotBundler_);
 }
 
 void EmbeddedServer::serializeObject(const std::shared_ptr<Object>& object, std::vector<uint8_t>& data) {
-
-    Object* obj = object.get();
-    if (!obj) {
+    if (!object) {
         std::cerr << "[EmbeddedServer] Error: Attempted to serialize a null object" << std::endl;
         return; // Return empty data if object is null
     }
-    size_t initialSize = data.size();
-    // a) Type
-    data.push_back(static_cast<uint8_t>(obj->type));
-    
-    // b) ID - now a uint16_t
-    uint16_t id = obj->getObjID();
-    data.push_back(static_cast<uint8_t>(id & 0xFF));
-    data.push_back(static_cast<uint8_t>((id >> 8) & 0xFF));
-
-    // c) Position & Velocity
-    auto writeFloat = [&](float v) {
-        uint8_t* bytes = reinterpret_cast<uint8_t*>(&v);
-        for (size_t i = 0; i < sizeof(float); ++i)
-            data.push_back(bytes[i]);
-    };
-    
-    const Vec2& p = obj->getposition();
-    const Vec2& v = obj->getvelocity();
-    writeFloat(p.x);
-    writeFloat(p.y);
-    writeFloat(v.x);
-    writeFloat(v.y);
-    
-    // Extra fields for specific object types
-    switch(obj->type) {
-        case ObjectType::TILE: {
-            auto* plat = static_cast<Tile*>(obj);
-            data.push_back(plat->gettileIndex());
-            for (int i = 0; i < 4; ++i) {
-                data.push_back(static_cast<uint8_t>((plat->getFlags() >> (i * 8)) & 0xFF));
-            }
-            // Tilemap name length
-            const std::string& tileMapName = plat->gettileMapName();
-
-            data.push_back(static_cast<uint8_t>(tileMapName.size()));
-            // Tilemap name content
-            data.insert(data.end(), tileMapName.begin(), tileMapName.end());
-            size_t sizeAfterTile = data.size();
-            // std::cout << "[EmbeddedServer] Tile serialized, size: " << sizeAfterTile - initialSize << " bytes" << std::endl;
-            break;
-        }
-        case ObjectType::MINOTAUR: {
-            auto* mino = static_cast<Minotaur*>(obj);
-            data.push_back(static_cast<uint8_t>(mino->getAnimationState()));
-            data.push_back(static_cast<uint8_t>(mino->getDir()));
-            int16_t health = mino->getHealth();
-            data.push_back(static_cast<uint8_t>(health >> 8));
-            data.push_back(static_cast<uint8_t>(health & 0xFF));
-            break;
-        }
-        case ObjectType::PLAYER: {
-            auto* player = static_cast<Player*>(obj);
-            data.push_back(static_cast<uint8_t>(player->getAnimationState()));
-            data.push_back(static_cast<uint8_t>(player->getDir()));
-            int16_t health = player->getHealth();
-            data.push_back(static_cast<uint8_t>(health >> 8));
-            data.push_back(static_cast<uint8_t>(health & 0xFF));
-            break;
-        }
-        default:
-            break;
-    }
+    serializeObject(ObjectSnapshot::fromObject(*object), data);
+}
+
+void EmbeddedServer::serializeObject(const ObjectSnapshot& obj, std::vector<uint8_t>& data) {
+    WireSchema::append(obj, data);
 }
 
 
 /**
- * Sends the full game state to a specific client.
- * If the game state is too large, it will be split into multiple packets.
- * Each packet will contain metadata to indicate if it's the first or last part.
+ * Sends the full game state to a specific client as a single GAME_STATE message.
  */
-void EmbeddedServer::sendFullGameStateToClient(const uint16_t playerId) {
-
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
-    Level* lvl = levelManager_->getCurrentLevel();
-    if (!lvl) {
-        std::cerr << "[EmbeddedServer] No active level for full game state sync" << std::endl;
-        return;
+void EmbeddedServer::sendFullGameStateToClient(const LevelSnapshot& level, const uint16_t playerId) {
+    ObjectSnapshotRefs objects(&snapshotArena_);
+    objects.reserve(level.objects.size());
+    for (const auto& obj : level.objects) {
+        objects.push_back(&obj);
     }
-    auto objects = lvl->getObjects();
-    
-    // Calculate estimated size of the serialized data
-    size_t estimatedSize = calculateMessageSize(objects);
     
     std::cout << "[EmbeddedServer] Sending full game state to client " << playerId 
               << " with " << objects.size() << " objects" << std::endl;
-    
-    // Check if we need to split the message into multiple packets
-    if (estimatedSize > MAX_GAMESTATE_PACKET_SIZE) {
-        sendSplitGameStateToClient(objects, estimatedSize, playerId);
-    } else {
-        sendSingleGameStatePacketToClient(objects, playerId);
-    }
+    sendSingleGameStatePacketToClient(objects, *level.tilesetNames, playerId);
 }
\ No newline at end of file
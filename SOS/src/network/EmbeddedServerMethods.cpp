@@ -3,44 +3,41 @@
 #include "objects/tile.h"
 #include "objects/minotaur.h"
 #include "player_manager.h"
+#include "network/WireSchema.h"
 #include <iostream>
 #include <cmath>
+#include <cstring>
 
-NetworkMessage EmbeddedServer::deserializeMessage(const std::vector<uint8_t>& data, const uint16_t clientId) {
+NetworkMessage EmbeddedServer::deserializeMessage(const uint8_t* data, size_t size, const uint16_t clientId) {
     NetworkMessage message;
+    message.senderId = clientId; // Use the provided client ID
+    message.targetId = 0;
     
     // Make sure we have at least the type byte
-    if (data.empty()) {
+    if (size == 0) {
         std::cerr << "[EmbeddedServer] Empty message data received" << std::endl;
         message.type = MessageType::PING; // Default to harmless message type
-        message.senderId = clientId; // Use the provided client ID
-        return message;
-    }
-    
-    message.senderId = clientId; // Use the provided client ID
-    // Extract message type (1 byte)
-    if (data.size() < 1) {
-        std::cerr << "[EmbeddedServer] Message too short for type" << std::endl;
-        message.type = MessageType::PING;
-        message.senderId = clientId;
         return message;
     }
     message.type = static_cast<MessageType>(data[0]);
 
-    // Extract message data (everything after byte 2)
-    if (data.size() > 3) {
-        message.data = std::vector<uint8_t>(data.begin() + 3, data.end());
-    } else {
-        message.data.clear();
+    // Extract message data (everything after the type, sender ID and data length)
+    constexpr size_t headerSize = 1 + sizeof(uint16_t) + sizeof(uint32_t);
+    if (size > headerSize) {
+        const uint32_t dataSize = (static_cast<uint32_t>(data[3]) << 24) | (static_cast<uint32_t>(data[4]) << 16) |
+                                  (static_cast<uint32_t>(data[5]) << 8) | static_cast<uint32_t>(data[6]);
+        if (dataSize == size - headerSize) {
+            message.data = receivePool_.acquire(dataSize);
+            std::memcpy(message.data.data(), data + headerSize, dataSize);
+        }
     }
     return message;
 }
 
 void EmbeddedServer::processPlayerInput(const uint16_t playerId, const NetworkMessage& message) {
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
     return;
     // Lookup the player
-    auto& pm = PlayerManager::getInstance();
+    auto& pm = levelManager_->getPlayerManager();
     auto player = pm.getPlayer(playerId);
     if (!player) {
         std::cerr << "[EmbeddedServer] Player not found for input: " << playerId << std::endl;
@@ -103,47 +100,33 @@ void EmbeddedServer::processPlayerInput(const uint16_t playerId, const NetworkMe
 }
 
 void EmbeddedServer::processPlayerPosition(const uint16_t playerId, const NetworkMessage& message) {
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
-    
     // This is used as a fallback/reconciliation mechanism
     // The server is authoritative, but we allow clients to send occasional position updates
     // which can help correct errors or deal with special conditions
     
     // Lookup the player
-    auto& pm = PlayerManager::getInstance();
+    auto& pm = levelManager_->getPlayerManager();
     auto player = pm.getPlayer(playerId);
     if (!player) {
         std::cerr << "[EmbeddedServer] Player not found for position update: " << playerId << std::endl;
         return;
     }
 
-    // Need at least 16 bytes for position/velocity
-    if (message.data.size() < 16) {
+    WireSchema::PlayerState state;
+    if (!WireSchema::decode(message.data, state)) {
         std::cerr << "[EmbeddedServer] Invalid player position data size: " << message.data.size() << std::endl;
         return;
     }
     
-    // Extract position and velocity
-    float posX, posY, velX, velY;
-    std::memcpy(&posX, &message.data[4], sizeof(float));
-    std::memcpy(&posY, &message.data[8], sizeof(float));
-    std::memcpy(&velX, &message.data[12], sizeof(float));
-    std::memcpy(&velY, &message.data[16], sizeof(float));
-    
     // Update player state
-    player->setcollider(BoxCollider(Vec2(posX, posY), player->getcollider().size));
-    player->setvelocity(Vec2(velX, velY));
+    player->setcollider(BoxCollider(state.position, player->getcollider().size));
+    player->setvelocity(state.velocity);
+    player->setDir(static_cast<FacingDirection>(state.direction));
     
-    // Extract animation state and direction if provided
-    if (message.data.size() >= 18) {
-        FacingDirection dir = static_cast<FacingDirection>(message.data[20]);
-        AnimationState animState = static_cast<AnimationState>(message.data[21]);
-        
-        player->setDir(dir);
-        player->setAnimationState(animState);
-        if(animState == AnimationState::ATTACKING) {
-            player->attack();
-        }
+    AnimationState animState = static_cast<AnimationState>(state.animState);
+    player->setAnimationState(animState);
+    if(animState == AnimationState::ATTACKING) {
+        player->attack();
     }
 }
 
@@ -151,100 +134,55 @@ void EmbeddedServer::processEnemyState(
     const uint16_t playerId,
     const NetworkMessage& message
 ) {
-    std::lock_guard<std::mutex> lock(gameStateMutex_);
-
     // Parse enemy state data from message
-    if (message.data.size() < sizeof(uint16_t) + sizeof(bool) + sizeof(int16_t)) {
+    WireSchema::EnemyState state;
+    if (!WireSchema::decode(message.data, state)) {
         std::cerr << "[EmbeddedServer] Invalid enemy state message size" << std::endl;
         return;
     }
+    const uint16_t enemyId = state.enemyId;
+    const bool isDead = state.isDead != 0;
+    const int16_t currentHealth = state.health;
 
-    // Extract enemy ID, isDead flag, and health
-    size_t offset = 4;
-
-    // Read enemy ID (2 bytes)
-    uint16_t enemyId;
-    std::memcpy(&enemyId, message.data.data() + offset, sizeof(uint16_t));
-    offset += sizeof(uint16_t);
-
-    
-    // Read isDead flag (1 byte)
-    if (offset >= message.data.size()) {
-        std::cerr << "[EmbeddedServer] Missing isDead flag" << std::endl;
-        return;
-    }
-    bool isDead = message.data[offset] != 0;
-    offset += 1;
-    
-    // Read health (2 bytes)
-    if (offset + sizeof(int16_t) > message.data.size()) {
-        std::cerr << "[EmbeddedServer] Missing health data" << std::endl;
-        return;
-    }
-    int16_t currentHealth;
-    std::memcpy(&currentHealth, message.data.data() + offset, sizeof(int16_t));
-    offset += sizeof(int16_t);
-
-
-    // Update enemy state in the level
-    if (levelManager_ && levelManager_->getCurrentLevel()) {
-        Level* currentLevel = levelManager_->getCurrentLevel();
+    // Update enemy state in the sender's level
+    if (levelManager_ && levelManager_->getLevelForPlayer(playerId)) {
+        Level* currentLevel = levelManager_->getLevelForPlayer(playerId);
         
-        // Find the enemy in the level
-        auto& objects = currentLevel->getObjects();
-        auto enemyIt = std::find_if(objects.begin(), objects.end(),
-            [&enemyId](const std::shared_ptr<Object>& obj) {
-                return obj && obj->getObjID() == enemyId;
-            });
+        // Find the enemy in the level by ID
+        std::shared_ptr<Object> enemyObject = currentLevel->findSharedObject(enemyId);
         
-        if (enemyIt != objects.end()) {
+        if (enemyObject) {
             if (isDead) {
                 // Remove the enemy from the level
-                currentLevel->removeObject(*enemyIt);
+                currentLevel->removeObject(enemyObject);
                 std::cout << "[EmbeddedServer] Removed dead enemy: " << enemyId << std::endl;
             } else {
                 // Update enemy health
-                Enemy* enemy = dynamic_cast<Enemy*>(enemyIt->get());
+                Enemy* enemy = dynamic_cast<Enemy*>(enemyObject.get());
                 if (enemy) {
                     enemy->setHealth(currentHealth);
                     std::cout << "[EmbeddedServer] Updated enemy " << enemyId << " health to " << currentHealth << std::endl;
                 }
             }
             
-            // Broadcast the enemy state change to ALL other clients
-            sendEnemyStateToClients(enemyId, isDead, currentHealth);
+            // Broadcast the enemy state change to all clients in the level
+            sendEnemyStateToClients(enemyId, isDead, currentHealth, currentLevel);
         }
     }
 }
 
-void EmbeddedServer::sendEnemyStateToClients(const uint16_t enemyId, bool isDead, int16_t health)
+void EmbeddedServer::sendEnemyStateToClients(const uint16_t enemyId, bool isDead, int16_t health, const Level* level)
 {
     NetworkMessage enemyMsg;
     enemyMsg.type = MessageType::ENEMY_STATE_UPDATE;
+    enemyMsg.senderId = 0;
 
-
-    enemyMsg.data.push_back(static_cast<uint8_t>(enemyId >> 8)); // High byte
-    enemyMsg.data.push_back(static_cast<uint8_t>(enemyId & 0xFF)); // Low byte
-
-    // Insert isDead flag (1 byte)
-    enemyMsg.data.push_back(static_cast<uint8_t>(isDead ? 1 : 0));
-
-    // Add health (2 bytes) - Use memcpy for consistent byte order
-    size_t currentSize = enemyMsg.data.size();
-    enemyMsg.data.resize(currentSize + sizeof(int16_t));
-    std::memcpy(enemyMsg.data.data() + currentSize, &health, sizeof(int16_t));
+    WireSchema::EnemyState state;
+    state.enemyId = enemyId;
+    state.isDead = isDead ? 1 : 0;
+    state.health = health;
+    enemyMsg.data = WireSchema::encode(state);
     
-    // Broadcast to all clients
-    {
-        std::lock_guard<std::mutex> lock(clientSocketsMutex_);
-        if (clientSockets_.empty()) {
-            return;
-        }
-        
-        for (auto& [id, sock] : clientSockets_) {
-            if (sock && sock->is_open()) {
-                sendToClient(sock, enemyMsg);
-            }
-        }
-    }
+    // Broadcast to the clients in the level
+    broadcastToClients(enemyMsg, clientsInLevel(level, &tickArena_), &tickBundler_);
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "network/LobbyRouter.h"
+#include <iostream>
+
+LobbyRouter::LobbyRouter(int port, const std::filesystem::path& basePath)
+    : port_(port),
+      basePath_(basePath),
+      running_(false),
+      acceptor_(io_context_),
+      retryTimer_(io_context_) {
+    std::cout << "[LobbyRouter] Created on port " << port << std::endl;
+}
+
+LobbyRouter::~LobbyRouter() {
+    stop();
+}
+
+void LobbyRouter::start() {
+    if (running_) {
+        std::cerr << "[LobbyRouter] Already running" << std::endl;
+        return;
+    }
+
+    try {
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port_);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+        std::cout << "[LobbyRouter] Now listening on port " << port_ << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[LobbyRouter] Failed to listen on port " << port_ << ": " << e.what() << std::endl;
+        boost::system::error_code ec;
+        acceptor_.close(ec);
+        return;
+    }
+
+    running_ = true;
+    for (int i = 0; i < NetworkConfig::Server::LobbyInitialSessions; ++i) {
+        auto session = createSession();
+        if (session) {
+            std::lock_guard<std::mutex> lock(sessionsMutex_);
+            sessions_.push_back(std::move(session));
+            std::cout << "[LobbyRouter] Started session " << sessions_.size() << std::endl;
+        }
+    }
+
+    startAccept();
+    acceptThread_ = std::thread([this]() {
+        try {
+            io_context_.run();
+        } catch (const std::exception& e) {
+            std::cerr << "[LobbyRouter] Accept thread error: " << e.what() << std::endl;
+        }
+    });
+    std::cout << "[LobbyRouter] Started" << std::endl;
+}
+
+void LobbyRouter::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+    // Stop routing first so no connection is handed to a session that is shutting down
+    boost::asio::post(io_context_, [this]() {
+        boost::system::error_code ec;
+        acceptor_.close(ec);
+        retryTimer_.cancel();
+    });
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    // A session still starting is added to the list and stopped with the others
+    if (spawnThread_.joinable()) {
+        spawnThread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    for (auto& session : sessions_) {
+        session->stop();
+    }
+    sessions_.clear();
+    std::cout << "[LobbyRouter] Stopped" << std::endl;
+}
+
+bool LobbyRouter::isRunning() const {
+    return running_;
+}
+
+void LobbyRouter::setSessionIoThreadCount(size_t count) {
+    if (running_) {
+        std::cerr << "[LobbyRouter] Session IO thread count can only be changed before start()" << std::endl;
+        return;
+    }
+    sessionIoThreadCount_ = count > 0 ? count : 1;
+}
+
+size_t LobbyRouter::getSessionCount() {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    return sessions_.size();
+}
+
+void LobbyRouter::startAccept() {
+    EmbeddedServer* session = selectSession();
+    if (!session) {
+        bool spawning;
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex_);
+            spawning = spawning_;
+        }
+        if (!spawning && !holdingConnections_) {
+            holdingConnections_ = true;
+            std::cerr << "[LobbyRouter] All " << NetworkConfig::Server::LobbyMaxSessions
+                      << " sessions are full, holding new connections" << std::endl;
+        }
+        // A starting session has room soon, check again shortly
+        int retryInterval = spawning ? NetworkConfig::Server::LobbySpawnRetryInterval
+                                     : NetworkConfig::Server::LobbyFullRetryInterval;
+        retryTimer_.expires_after(std::chrono::milliseconds(retryInterval));
+        retryTimer_.async_wait([this](const boost::system::error_code& error) {
+            if (!error && running_) {
+                startAccept();
+            }
+        });
+        return;
+    }
+    holdingConnections_ = false;
+
+    // Player slots only free up while we wait, so the session still has room once the
+    // connection arrives. Accepting into its io_context means no socket hand-off later.
+    acceptor_.async_accept(boost::asio::make_strand(session->getIoContext()),
+        [this, session](const boost::system::error_code& error, boost::asio::ip::tcp::socket socket) {
+            if (!error) {
+                auto client = std::make_shared<boost::asio::ip::tcp::socket>(std::move(socket));
+                if (!session->adoptClient(client)) {
+                    std::cerr << "[LobbyRouter] Session refused client, closing connection" << std::endl;
+                    boost::system::error_code ec;
+                    client->close(ec);
+                }
+            } else if (error != boost::asio::error::operation_aborted) {
+                std::cerr << "[LobbyRouter] Accept error: " << error.message() << std::endl;
+            }
+
+            if (running_) {
+                startAccept();
+            }
+        });
+}
+
+EmbeddedServer* LobbyRouter::selectSession() {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    // Fill sessions in order so players end up together
+    EmbeddedServer* selected = nullptr;
+    size_t freeSlots = 0;
+    for (auto& session : sessions_) {
+        if (!session->isRunning()) {
+            continue;
+        }
+        size_t clients = session->getClientCount();
+        if (clients < static_cast<size_t>(NetworkConfig::MaxPlayers)) {
+            freeSlots += NetworkConfig::MaxPlayers - clients;
+            if (!selected) {
+                selected = session.get();
+            }
+        }
+    }
+    // The connection takes the last free slot (or there is none), so the next
+    // session starts now instead of when the next player is already waiting
+    if (freeSlots <= 1) {
+        spawnSession();
+    }
+    return selected;
+}
+
+void LobbyRouter::spawnSession() {
+    if (spawning_ || !running_ ||
+        sessions_.size() >= static_cast<size_t>(NetworkConfig::Server::LobbyMaxSessions)) {
+        return;
+    }
+    // The previous spawn has finished, spawning_ is only cleared at its end
+    if (spawnThread_.joinable()) {
+        spawnThread_.join();
+    }
+    spawning_ = true;
+    spawnThread_ = std::thread([this]() {
+        // Loads the level, so it runs here and not on the accept thread
+        auto session = createSession();
+        std::lock_guard<std::mutex> lock(sessionsMutex_);
+        if (session) {
+            sessions_.push_back(std::move(session));
+            std::cout << "[LobbyRouter] Started session " << sessions_.size() << std::endl;
+        }
+        spawning_ = false;
+    });
+}
+
+std::unique_ptr<EmbeddedServer> LobbyRouter::createSession() {
+    auto session = std::make_unique<EmbeddedServer>(port_, basePath_, true);
+    session->setAcceptConnections(false);
+    session->setIoThreadCount(sessionIoThreadCount_);
+    session->start();
+    if (!session->isRunning()) {
+        std::cerr << "[LobbyRouter] Failed to start session" << std::endl;
+        return nullptr;
+    }
+    return session;
+}
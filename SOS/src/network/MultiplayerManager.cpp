@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 #include "network/MultiplayerManager.h"
@@ -6,6 +7,8 @@
 #include "utils/TimeUtils.h"  // Include proper header for get_ticks()
 #include "interfaces/playerInput.h"  // Add player input header
 #include "game.h"
+#include "network/SnapshotCodec.h"
+#include "network/WireSchema.h"
 #include <algorithm>
 
 // External function declaration
@@ -17,8 +20,7 @@ MultiplayerManager::MultiplayerManager()
       playerInput_(nullptr),
       lastUpdateTime_(0),
       lastSentInputTime_(0.0f),
-      inputSequenceNumber_(0),
-      partialGameState_(nullptr) {
+      inputSequenceNumber_(0) {
     // Create the network interface
     network_ = std::make_unique<AsioNetworkClient>();
     std::filesystem::path base = std::filesystem::current_path();
@@ -45,7 +47,8 @@ MultiplayerManager::~MultiplayerManager() {
     remotePlayers_.clear();
 }
 
-bool MultiplayerManager::initialize(const std::string& serverAddress, int serverPort, const uint16_t initialPlayerId) {
+bool MultiplayerManager::initialize(const std::string& serverAddress, int serverPort, const uint16_t initialPlayerId,
+                                    const std::string& levelId) {
     // Store an initial temporary player ID
     playerId_ = 65000; // Will be replaced by server-assigned ID
     
@@ -64,6 +67,16 @@ bool MultiplayerManager::initialize(const std::string& serverAddress, int server
         NetworkMessage connectMsg;
         connectMsg.type = MessageType::CONNECT;
         connectMsg.senderId = 65000; // Temporary ID that will be replaced by server-assigned ID
+        // [u8 level id length][level id][u8 flags]; no level id joins the server's default level
+        uint8_t flags = 0;
+        if (NetworkConfig::Client::RequestCompressedState) {
+            flags |= ConnectFlags::CompressedState;
+        }
+        const size_t levelIdLength = std::min<size_t>(levelId.size(), 255);
+        connectMsg.data.reserve(levelIdLength + 2);
+        connectMsg.data.push_back(static_cast<uint8_t>(levelIdLength));
+        connectMsg.data.insert(connectMsg.data.end(), levelId.begin(), levelId.begin() + levelIdLength);
+        connectMsg.data.push_back(flags);
         
         std::cout << "[Client] Sending CONNECT message to get server-assigned ID" << std::endl;
         // Sleep for a short time to ensure server is ready
@@ -107,19 +120,6 @@ void MultiplayerManager::update(float deltaTime) {
     static uint64_t lastUpdateTime = 0;
     lastUpdateTime += static_cast<uint64_t>(deltaTime*1000);  // Convert to milliseconds
 
-    // Check for timed-out partial game state updates
-    if (partialGameState_) {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-            now - partialGameState_->lastUpdateTime).count();
-        
-        // If we haven't received an update for more than 2 seconds, abandon this partial state
-        if (elapsed > 2) {
-            std::cerr << "[Client] Abandoning stale partial game state update" << std::endl;
-            partialGameState_.reset();
-        }
-    }
-    
     // Send player input periodically (primary control method now)
     if (playerInput_ && localPlayer_ && lastUpdateTime >= NetworkConfig::Client::UpdateInterval) {
         sendPlayerInput();
@@ -195,23 +195,11 @@ void MultiplayerManager::sendEnemyStateUpdate(const uint16_t enemyId, bool isDea
     enemyStateMsg.type = MessageType::ENEMY_STATE_UPDATE; // Reuse existing message type
     enemyStateMsg.senderId = playerId_; // Send as the local player
     
-    // Encode the enemy state in the data payload
-    // Format: [enemy ID length][enemy ID string][1 byte isDead][4 bytes health]
-    std::vector<uint8_t> data; 
-
-    size_t currentSize = data.size();
-    data.resize(currentSize + sizeof(int16_t));
-    std::memcpy(data.data() + currentSize, &enemyId, sizeof(int16_t));
-
-    // Add isDead flag
-    data.push_back(isDead ? 1 : 0);
-    
-    // Add current health (2 bytes) - Use memcpy for consistent byte order
-    currentSize = data.size();
-    data.resize(currentSize + sizeof(int16_t));
-    std::memcpy(data.data() + currentSize, &currentHealth, sizeof(int16_t));
-
-    enemyStateMsg.data = data;
+    WireSchema::EnemyState state;
+    state.enemyId = enemyId;
+    state.isDead = isDead ? 1 : 0;
+    state.health = currentHealth;
+    enemyStateMsg.data = WireSchema::encode(state);
     
     // Send the message to the server
     network_->sendMessage(enemyStateMsg);
@@ -220,24 +208,14 @@ void MultiplayerManager::sendEnemyStateUpdate(const uint16_t enemyId, bool isDea
 void MultiplayerManager::handleEnemyStateMessage(const NetworkMessage& message) {
     // This method is called by the server to handle enemy state updates
     // It updates enemy health, dead status, etc.
-    if (message.data.size() < sizeof(uint16_t) + 1 + sizeof(int16_t)) {
+    WireSchema::EnemyState state;
+    if (!WireSchema::decode(message.data, state)) {
         std::cerr << "[Client] Invalid enemy state update message received" << std::endl;
         return;
     }
-    size_t pos = 0;
-
-    // Read enemy ID (2 bytes)
-    uint16_t enemyId;
-    std::memcpy(&enemyId, message.data.data() + pos, sizeof(uint16_t));
-    pos += sizeof(uint16_t);
-
-    // Read isDead flag (1 byte)
-    bool isDead = message.data[pos++] != 0;
-
-    // Read health (2 bytes)
-    int16_t health;
-    std::memcpy(&health, message.data.data() + pos, sizeof(int16_t));
-    pos += sizeof(int16_t);
+    const uint16_t enemyId = state.enemyId;
+    const bool isDead = state.isDead != 0;
+    const int16_t health = state.health;
 
     // Find the enemy object by ID in gameObjects
     Game* game = Game::getInstance();
@@ -246,18 +224,14 @@ void MultiplayerManager::handleEnemyStateMessage(const NetworkMessage& message)
         return;
     }
     std::shared_ptr<Enemy> enemyObject = nullptr;
-    auto& objects = game->getObjects();
-    for (auto& obj : objects) {
-        if (obj->getObjID() == enemyId) {
-            switch(obj->type) {
-                case ObjectType::MINOTAUR:
-                    enemyObject = std::static_pointer_cast<Minotaur>(obj);
-                    break;
-                default:
-                    std::cerr << "[Client] Object with ID " << enemyId << " is not recognized as an enemy type" << std::endl;
-                    return;
-            }
-            break;
+    if (const std::shared_ptr<Object>& obj = game->findObject(enemyId)) {
+        switch(obj->type) {
+            case ObjectType::MINOTAUR:
+                enemyObject = std::static_pointer_cast<Minotaur>(obj);
+                break;
+            default:
+                std::cerr << "[Client] Object with ID " << enemyId << " is not recognized as an enemy type" << std::endl;
+                return;
         }
     }
     if (!enemyObject) {
@@ -288,7 +262,9 @@ void MultiplayerManager::sendChatMessage(const std::string& message) {
     NetworkMessage chatMsg;
     chatMsg.type = MessageType::CHAT_MESSAGE;
     chatMsg.senderId = playerId_;
-    chatMsg.data.assign(message.begin(), message.end());
+    // Longer frames would make the server drop the connection
+    chatMsg.data.assign(message.begin(),
+                        message.begin() + std::min<size_t>(message.size(), NetworkConfig::MaxChatMessageSize));
     
     network_->sendMessage(chatMsg);
 }
@@ -313,9 +289,8 @@ void MultiplayerManager::handleNetworkMessage(const NetworkMessage& message) {
             // Handle delta game state updates
             processGameStateDelta(message.data);
             break;
-        case MessageType::GAME_STATE_PART:
-            // Handle part of a multi-packet game state update
-            processGameStatePart(message.data);
+        case MessageType::TILESET_TABLE:
+            handleTilesetTableMessage(message);
             break;
         case MessageType::CHAT_MESSAGE:
             handleChatMessage(message);
@@ -416,7 +391,7 @@ void MultiplayerManager::handleGameStateMessage(const NetworkMessage& message) {
     // Process game state updates from the server
     // This now contains authoritative position/physics data from the server
     
-    if (message.data.size() < 2) {
+    if (message.data.empty()) {
         std::cerr << "[Client] Game state data is too small: " << message.data.size() << " bytes" << std::endl;
         return;
     }
@@ -433,11 +408,6 @@ void MultiplayerManager::handleGameStateMessage(const NetworkMessage& message) {
             processGameStateDelta(message.data);
             break;
             
-        case MessageType::GAME_STATE_PART:
-            // Part of a multi-packet game state update
-            processGameStatePart(message.data);
-            break;
-            
         default:
             std::cerr << "[Client] Unknown game state message type: " << 
                 static_cast<int>(message.type) << std::endl;
@@ -446,31 +416,20 @@ void MultiplayerManager::handleGameStateMessage(const NetworkMessage& message) {
 }
 
 void MultiplayerManager::processGameState(const std::vector<uint8_t>& gameStateData) {
-    if (gameStateData.size() < 2) {
+    if (!SnapshotCodec::decode(gameStateData.data(), gameStateData.size(), decodedObjects_)) {
         std::cerr << "[Client] Invalid game state data received" << std::endl;
         return;
     }
     
-    // The first 2 bytes contain the object count
-    uint16_t objectCount = (static_cast<uint16_t>(gameStateData[0]) << 8) | 
-                           static_cast<uint16_t>(gameStateData[1]);
-    
-    // Current position in the data stream
-    size_t pos = 2;
-    
-    // Maps to track objects we've seen in this update
-    std::map<uint16_t, bool> objectsSeen;
     std::vector<std::shared_ptr<Object>> newObjects;
     
     // Process each object
-    for (uint16_t i = 0; i < objectCount && pos < gameStateData.size(); i++) {
-        // std::cout << "[Client] Processing object " << i + 1 << " of " << objectCount << ". Pos: " << pos << std::endl;
-        std::shared_ptr<Object> newobj = deserializeObject(gameStateData, pos);
+    for (const ObjectSnapshot& record : decodedObjects_) {
+        std::shared_ptr<Object> newobj = applyObjectRecord(record);
         if (!newobj) {
-            continue; // Object deserialization failed, skip to next
+            continue; // Unknown object type, skip to next
         }
         newObjects.push_back(newobj);
-        objectsSeen[newobj->getObjID()] = true;  // Mark this object as seen
     }
     // Add any new objects to the game
     if (Game* game = Game::getInstance()) {
@@ -481,41 +440,26 @@ void MultiplayerManager::processGameState(const std::vector<uint8_t>& gameStateD
 }
 
 void MultiplayerManager::processGameStateDelta(const std::vector<uint8_t>& gameStateData) {
-    if (gameStateData.size() < 2) {
+    if (!SnapshotCodec::decode(gameStateData.data(), gameStateData.size(), decodedObjects_)) {
         std::cerr << "[Client] Invalid delta game state data received" << std::endl;
         return;
     }
     
-    // The first 2 bytes contain the object count
-    uint16_t objectCount = (static_cast<uint16_t>(gameStateData[0]) << 8) | 
-                           static_cast<uint16_t>(gameStateData[1]);
-    
-    // If it's 0, this is just a heartbeat message with no changes
-    if (objectCount == 0) {
+    // If it's empty, this is just a heartbeat message with no changes
+    if (decodedObjects_.empty()) {
         return;
     }
     
-    // std::cout << "[Client] Processing delta game state with " << objectCount 
-    //           << " changed objects" << std::endl;
-    
-    // The rest of the processing is the same as processGameState
-    // We're only receiving changed objects, so the processing logic remains the same
-    
-    // Current position in the data stream
-    size_t pos = 2;
-    
-    // Track objects we've seen
-    std::map<uint16_t, bool> objectsSeen;
+    // We're only receiving changed objects, so the processing logic is the same as processGameState
     std::vector<std::shared_ptr<Object>> newObjects;
     
     // Process each object
-    for (uint16_t i = 0; i < objectCount && pos < gameStateData.size(); i++) {
-        std::shared_ptr<Object> newobj = deserializeObject(gameStateData, pos);
+    for (const ObjectSnapshot& record : decodedObjects_) {
+        std::shared_ptr<Object> newobj = applyObjectRecord(record);
         if (!newobj) {
-            continue; // Object deserialization success and there was no new object to be added
+            continue; // Unknown object type, skip to next
         }
         newObjects.push_back(newobj);
-        objectsSeen[newobj->getObjID()] = true;  // Mark this object as seen
     }
     
     // Add any new objects to the game
@@ -526,128 +470,34 @@ void MultiplayerManager::processGameStateDelta(const std::vector<uint8_t>& gameS
     }
 }
 
-void MultiplayerManager::processGameStatePart(const std::vector<uint8_t>& gameStateData) {
-    if (gameStateData.size() < 7) {
-        std::cerr << "[Client] Invalid partial game state data received (too small)" << std::endl;
+void MultiplayerManager::handleTilesetTableMessage(const NetworkMessage& message) {
+    std::vector<std::string> names;
+    if (!WireSchema::decodeTilesetTable(message.data, names)) {
+        std::cerr << "[Client] Invalid tileset table received" << std::endl;
         return;
     }
-    
-    // Parse metadata
-    // First byte: flags (isFirst | isLast)
-    uint8_t flags = gameStateData[0];
-    bool isFirstPacket = (flags & 0x01) != 0;
-    bool isLastPacket = (flags & 0x02) != 0;
-    
-    // Next 2 bytes: total object count
-    uint16_t totalObjectCount = (static_cast<uint16_t>(gameStateData[1]) << 8) | 
-                                static_cast<uint16_t>(gameStateData[2]);
-    
-    // Next 2 bytes: start index
-    uint16_t startIndex = (static_cast<uint16_t>(gameStateData[3]) << 8) | 
-                          static_cast<uint16_t>(gameStateData[4]);
-    
-    // Next 2 bytes: object count in this packet
-    uint16_t packetObjectCount = (static_cast<uint16_t>(gameStateData[5]) << 8) | 
-                                 static_cast<uint16_t>(gameStateData[6]);
-    
-    // std::cout << "[Client] Received game state part: " 
-    //           << (isFirstPacket ? "first " : "")
-    //           << (isLastPacket ? "last " : "")
-    //           << "packet with " << packetObjectCount 
-    //           << " objects (total: " << totalObjectCount 
-    //           << ", starting at index: " << startIndex << ")" << std::endl;
-    
-    // If this is the first packet, initialize our partial state storage
-    if (isFirstPacket) {
-        partialGameState_ = std::make_unique<PartialGameState>();
-        partialGameState_->totalObjectCount = totalObjectCount;
-        partialGameState_->complete = false;
-        partialGameState_->packetIndices.clear();
-        partialGameState_->parts.clear();
-        partialGameState_->lastUpdateTime = std::chrono::steady_clock::now();
-    }
-    
-    // If we don't have an active partial state or the object count doesn't match,
-    // something is wrong - reset and wait for the next full update
-    if (!partialGameState_ || partialGameState_->totalObjectCount != totalObjectCount) {
-        std::cerr << "[Client] Received partial game state but no valid state accumulator exists" << std::endl;
-        partialGameState_.reset();
-        return;
+    // Sprite sheets are looked up again on first use, the level may have changed
+    tilesets_.clear();
+    tilesets_.reserve(names.size());
+    for (std::string& name : names) {
+        TilesetEntry entry;
+        entry.name = std::move(name);
+        tilesets_.push_back(std::move(entry));
     }
-    
-    // Reset timeout
-    partialGameState_->lastUpdateTime = std::chrono::steady_clock::now();
-    
-    // Store this part (we store just the object data part, skipping the header)
-    std::vector<uint8_t> objectData(gameStateData.begin() + 7, gameStateData.end());
-    
-    // Store the part with its corresponding start index
-    partialGameState_->parts.push_back(objectData);
-    partialGameState_->packetIndices.push_back(startIndex);
-    
-    // If this is the last packet, process the complete state
-    if (isLastPacket) {
-        partialGameState_->complete = true;
-        
-        bool hasAllParts = true;
-        std::set<uint16_t> receivedIndices;
-        for (auto idx : partialGameState_->packetIndices) {
-            receivedIndices.insert(idx);
-        }
-        
-        // Sort the indices to see what we have
-        std::vector<uint16_t> sortedIndices(receivedIndices.begin(), receivedIndices.end());
-        std::sort(sortedIndices.begin(), sortedIndices.end());
-        
-        // Check if we have all required parts by ensuring we have packets covering all objects
-        if (sortedIndices.empty() || sortedIndices.back() + packetObjectCount < totalObjectCount) {
-            hasAllParts = false;
-            std::cerr << "[Client] Incomplete game state: highest index " 
-                    << (sortedIndices.empty() ? 0 : sortedIndices.back())
-                    << " doesn't cover all " << totalObjectCount << " objects" << std::endl;
-        }
-        
-        // If we're missing parts, don't process
-        if (!hasAllParts) {
-            std::cerr << "[Client] Missing parts of game state update: received " 
-                    << partialGameState_->parts.size() << " parts" << std::endl;
-            
-            // For debugging, show what parts we do have
-            std::cout << "[Client] Received parts at indices: ";
-            for (auto idx : sortedIndices) {
-                std::cout << idx << " ";
-            }
-            std::cout << std::endl;
-            
-            return;
-        }
-        
-        // Sort parts by start index to ensure correct order
-        std::vector<std::pair<uint16_t, std::vector<uint8_t>>> indexedParts;
-        for (size_t i = 0; i < partialGameState_->parts.size(); i++) {
-            indexedParts.push_back({partialGameState_->packetIndices[i], partialGameState_->parts[i]});
-        }
-        std::sort(indexedParts.begin(), indexedParts.end(), 
-                 [](const auto& a, const auto& b) { return a.first < b.first; });
-        
-        // Combine all parts into a single game state
-        std::vector<uint8_t> completeState;
-        
-        // Add total object count
-        completeState.push_back(static_cast<uint8_t>(totalObjectCount >> 8));
-        completeState.push_back(static_cast<uint8_t>(totalObjectCount & 0xFF));
-        
-        // Add all object data in correct order
-        for (const auto& [_, part] : indexedParts) {
-            completeState.insert(completeState.end(), part.begin(), part.end());
+}
+
+const MultiplayerManager::TilesetEntry* MultiplayerManager::resolveTileset(uint16_t index) {
+    if (index >= tilesets_.size()) {
+        return nullptr;
+    }
+    TilesetEntry& entry = tilesets_[index];
+    if (!entry.resolved) {
+        if (!AnimationController::isHeadless()) {
+            entry.spriteSheet = SpriteData::getSharedInstance((atlasBasePath_ / (entry.name + ".tpsheet")).string());
         }
-        
-        // Process the complete state
-        processGameState(completeState);
-        
-        // Clear the partial state
-        partialGameState_.reset();
+        entry.resolved = true;
     }
+    return &entry;
 }
 
 void MultiplayerManager::handleChatMessage(const NetworkMessage& message) {
@@ -683,27 +533,12 @@ std::vector<uint8_t> MultiplayerManager::serializePlayerInput(const PlayerInput*
 }
 
 std::vector<uint8_t> MultiplayerManager::serializePlayerState(const Player* player) {
-    std::vector<uint8_t> data;
-    
-    // Get player position and velocity
-    const Vec2& pos = player->getcollider().position;
-    const Vec2& vel = player->getvelocity();
-    
-    // Allocate space for the data (2 Vec2s = 4 floats = 16 bytes)
-    data.resize(16);
-    
-    // Copy position (8 bytes)
-    std::memcpy(&data[0], &pos.x, sizeof(float));
-    std::memcpy(&data[4], &pos.y, sizeof(float));
-    
-    // Copy velocity (8 bytes)
-    std::memcpy(&data[8], &vel.x, sizeof(float));
-    std::memcpy(&data[12], &vel.y, sizeof(float));
-    // Add direction and animation state
-    data.push_back(static_cast<uint8_t>(player->getDir()));
-    data.push_back(static_cast<uint8_t>(player->getAnimationState()));
-    
-    return data;
+    WireSchema::PlayerState state;
+    state.position = player->getcollider().position;
+    state.velocity = player->getvelocity();
+    state.direction = static_cast<uint8_t>(player->getDir());
+    state.animState = static_cast<uint8_t>(player->getAnimationState());
+    return WireSchema::encode(state);
 }
 
 std::shared_ptr<Object> MultiplayerManager::updateEntityPosition(const uint16_t objectId, const Vec2& position, const Vec2& velocity) {
@@ -713,41 +548,30 @@ std::shared_ptr<Object> MultiplayerManager::updateEntityPosition(const uint16_t
         std::cerr << "[Client] Game instance not found" << std::endl;
         return nullptr;
     }
-    auto& objects = game->getObjects();
-    for (auto& obj : objects) {
-        if (obj->getObjID() == objectId) {
-            // Update the object's position and velocity
-            obj->setcollider(BoxCollider(position, obj->getcollider().size));
-            obj->setvelocity(velocity);
-            return obj; // Successfully updated
-        }
+    const std::shared_ptr<Object>& obj = game->findObject(objectId);
+    if (!obj) {
+        return nullptr; // Object not found
     }
-    return nullptr; // Object not found
+    // Update the object's position and velocity
+    obj->setcollider(BoxCollider(position, obj->getcollider().size));
+    obj->setvelocity(velocity);
+    return obj; // Successfully updated
 }
 
 void MultiplayerManager::deserializePlayerState(const std::vector<uint8_t>& data, Player* player) {
-    if (data.size() < 18) { // 16 bytes for position/velocity + 2 bytes for state/dir
+    WireSchema::PlayerState state;
+    if (!WireSchema::decode(data, state)) {
         std::cerr << "[Client] Invalid player state data size: " << data.size() << std::endl;
         return;
     }
-    
-    // Extract position
-    float posX, posY;
-    std::memcpy(&posX, &data[0], sizeof(float));
-    std::memcpy(&posY, &data[4], sizeof(float));
-    
-    // Extract velocity
-    float velX, velY;
-    std::memcpy(&velX, &data[8], sizeof(float));
-    std::memcpy(&velY, &data[12], sizeof(float));
-    
-    // Extract direction and animation state
-    FacingDirection dir = static_cast<FacingDirection>(data[16]);
-    AnimationState animState = static_cast<AnimationState>(data[17]);
+    const float posX = state.position.x;
+    const float posY = state.position.y;
+    const float velX = state.velocity.x;
+    const float velY = state.velocity.y;
     
     // Update the remote player
-    player->setDir(dir);
-    player->setAnimationState(animState);
+    player->setDir(static_cast<FacingDirection>(state.direction));
+    player->setAnimationState(static_cast<AnimationState>(state.animState));
     player->setTargetPosition(Vec2(posX, posY));
     player->setTargetVelocity(Vec2(velX, velY));
     
@@ -761,43 +585,25 @@ void MultiplayerManager::deserializePlayerState(const std::vector<uint8_t>& data
 }
 
 std::shared_ptr<Object> MultiplayerManager::deserializeObject(const std::vector<uint8_t>& data, size_t& pos) {
-    if (pos + 2 > data.size()) {
-        // std::cerr << "[Client] Not enough data to read object type and ID length" << std::endl;
-        return nullptr;
-    }
-    
-    // Read object type
-    uint8_t objectType = data[pos++];
-    
-    // Read object ID (2 bytes for uint16_t)
-    if (pos + 2 > data.size()) {
-        std::cerr << "[Client] Not enough data to read object ID" << std::endl;
+    // The whole record is consumed up front, so objects that are only updated stay in sync
+    ObjectSnapshot record;
+    if (!WireSchema::decode(data.data(), data.size(), pos, record)) {
+        std::cerr << "[Client] Truncated object record at offset " << pos << std::endl;
+        pos = data.size();
         return nullptr;
     }
-    
-    // Read object ID as uint16_t (little endian format)
-    uint16_t objectId = static_cast<uint16_t>(data[pos]) | 
-                       (static_cast<uint16_t>(data[pos+1]) << 8);
-    pos += 2;
+    return applyObjectRecord(record);
+}
 
-    // Read position and velocity (4 floats, 16 bytes total)
-    if (pos + 16 > data.size()) {
-        std::cerr << "[Client] Not enough data to read position and velocity" << std::endl;
-        return nullptr;
-    }
-    
-    float posX, posY, velX, velY;
-    std::memcpy(&posX, &data[pos], sizeof(float));
-    pos += sizeof(float);
-    std::memcpy(&posY, &data[pos], sizeof(float));
-    pos += sizeof(float);
-    std::memcpy(&velX, &data[pos], sizeof(float));
-    pos += sizeof(float);
-    std::memcpy(&velY, &data[pos], sizeof(float));
-    pos += sizeof(float);
+std::shared_ptr<Object> MultiplayerManager::applyObjectRecord(const ObjectSnapshot& record) {
+    const uint16_t objectId = record.id;
+    const float posX = record.position.x;
+    const float posY = record.position.y;
+    const float velX = record.velocity.x;
+    const float velY = record.velocity.y;
     
     // Create the appropriate object based on type
-    switch (static_cast<ObjectType>(objectType)) {
+    switch (static_cast<ObjectType>(record.type)) {
         case ObjectType::PLAYER: {
             // Find or create a remote player
             auto it = remotePlayers_.find(objectId);
@@ -808,10 +614,8 @@ std::shared_ptr<Object> MultiplayerManager::deserializeObject(const std::vector<
                 it->second->setposition(Vec2(posX, posY));
             }
             Player* player = it->second.get();
-            AnimationState state = static_cast<AnimationState>(data[pos++]);
-            FacingDirection dir = static_cast<FacingDirection>(data[pos++]);
-            int16_t health = (data[pos] << 8) | data[pos + 1];
-            pos += 2; // Move past health
+            AnimationState state = static_cast<AnimationState>(record.animState);
+            FacingDirection dir = static_cast<FacingDirection>(record.direction);
 
             player->setDir(dir);
             player->setAnimationState(state);
@@ -828,50 +632,40 @@ std::shared_ptr<Object> MultiplayerManager::deserializeObject(const std::vector<
                 std::cerr << "[Client] Game instance not found" << std::endl;
                 return nullptr;
             }
-            auto& objects = game->getObjects();
-            for (auto& obj : objects) {
-                if (obj->getObjID() == objectId) {
-                    // Update existing platform
-                    obj->setcollider(BoxCollider(Vec2(posX, posY), obj->getcollider().size));
-                    obj->setvelocity(Vec2(velX, velY));
-                    
-                    return obj; // Successfully updated
-                }
+            if (const std::shared_ptr<Object>& obj = game->findObject(objectId)) {
+                // Update existing platform
+                obj->setcollider(BoxCollider(Vec2(posX, posY), obj->getcollider().size));
+                obj->setvelocity(Vec2(velX, velY));
+                
+                return obj; // Successfully updated
             }
             
-            uint8_t tileIndex = 2; // Default tile index
-            tileIndex = data[pos++];
-            uint32_t flags;
-            flags = (static_cast<uint32_t>(data[pos+3]) << 24) |
-            (static_cast<uint32_t>(data[pos + 2]) << 16) |
-            (static_cast<uint32_t>(data[pos + 1]) << 8) |
-            static_cast<uint32_t>(data[pos]);
-            pos += 4; // Move past the flags
-            
-            // Tilemap name length
-            uint8_t tilemapNameLength = data[pos++];
-            std::string tilemapName(data.begin() + pos, data.begin() + pos + tilemapNameLength);
-            pos += tilemapNameLength; // Move past the tilemap name
+            uint8_t tileIndex = record.tileIndex;
+            uint32_t flags = record.flags;
+            const TilesetEntry* tileset = resolveTileset(record.tilesetIndex);
+            if (!tileset) {
+                std::cerr << "[Client] Tile " << objectId << " refers to unknown tileset " << record.tilesetIndex << std::endl;
+                return nullptr;
+            }
 
             // Create new platform
             std::shared_ptr<Tile> platform = std::make_shared<Tile>(
                 posX, posY,
                 objectId,
-                tilemapName, tileIndex, 64, 64, 12 // Default tile index and size
+                tileset->name, tileIndex, 64, 64, 12, // Default tile index and size
+                record.tilesetIndex
             );
 
             platform->setFlag(flags);
             
-            platform->setupAnimations(atlasBasePath_);
+            platform->setupAnimations(tileset->spriteSheet);
             platform->setcollider(BoxCollider(Vec2(posX, posY), Vec2(64, 64))); // Default size
             platform->setvelocity(Vec2(velX, velY));
             return platform;
         }
         case ObjectType::MINOTAUR: {
-            AnimationState state = static_cast<AnimationState>(data[pos++]);
-            FacingDirection dir = static_cast<FacingDirection>(data[pos++]);
-            int16_t health = (data[pos] << 8) | data[pos + 1];
-            pos += 2; // Move past health
+            AnimationState state = static_cast<AnimationState>(record.animState);
+            FacingDirection dir = static_cast<FacingDirection>(record.direction);
             
             // Find or create a minotaur object
             Game* game = Game::getInstance();
@@ -879,19 +673,20 @@ std::shared_ptr<Object> MultiplayerManager::deserializeObject(const std::vector<
                 std::cerr << "[Client] Game instance not found" << std::endl;
                 return nullptr;
             }
-            auto& objects = game->getObjects();
-            for (auto& obj : objects) {
-                if (obj->getObjID() == objectId) {
-                    obj->setAnimationState(state);
-                    obj->setDir(dir);
-
-                    // Apply interpolation
-                    std::shared_ptr<Minotaur> minotaur = std::static_pointer_cast<Minotaur>(obj);
-                    minotaur->setTargetPosition(Vec2(posX, posY));
-                    minotaur->setTargetVelocity(Vec2(velX, velY));
-                    minotaur->resetInterpolation();
-                    return obj; // Successfully updated
+            if (const std::shared_ptr<Object>& obj = game->findObject(objectId)) {
+                if (obj->type != ObjectType::MINOTAUR) {
+                    std::cerr << "[Client] Object with ID " << objectId << " is not a minotaur" << std::endl;
+                    return nullptr;
                 }
+                obj->setAnimationState(state);
+                obj->setDir(dir);
+
+                // Apply interpolation
+                std::shared_ptr<Minotaur> minotaur = std::static_pointer_cast<Minotaur>(obj);
+                minotaur->setTargetPosition(Vec2(posX, posY));
+                minotaur->setTargetVelocity(Vec2(velX, velY));
+                minotaur->resetInterpolation();
+                return obj; // Successfully updated
             }
             // Create new minotaur
             auto newMinotaur = std::make_shared<Minotaur>(posX, posY, objectId);
@@ -904,7 +699,7 @@ std::shared_ptr<Object> MultiplayerManager::deserializeObject(const std::vector<
             return newMinotaur;
         }
         default:
-            // std::cerr << "[Client] Unknown object type: " << static_cast<int>(objectType) << std::endl;
+            // std::cerr << "[Client] Unknown object type: " << static_cast<int>(record.type) << std::endl;
             return nullptr;
     }
     
@@ -0,0 +1,155 @@
+#include "network/OutboundBundler.h"
+#include "network/NetworkConfig.h"
+#include "network/NetworkMessage.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Size prefix in front of every frame, dropped for bundled messages
+constexpr size_t FramePrefixSize = sizeof(uint32_t);
+// [type u8][sender u16 BE][data length u32 BE] of the bundle message itself
+constexpr size_t BodyHeaderSize = 1 + sizeof(uint16_t) + sizeof(uint32_t);
+}
+
+void OutboundBundler::add(const std::shared_ptr<ClientConnection>& connection, const Frame& frame, FrameKind kind) {
+    if (!connection || !frame || frame->size() <= FramePrefixSize) {
+        return;
+    }
+    const size_t bodySize = frame->size() - FramePrefixSize;
+    Pending& pending = pendingFor(connection);
+
+    if (bodySize > NetworkConfig::Server::MaxBundleBytes) {
+        // Copying a large frame into a bundle costs more than its header saves
+        sendRuns(pending, false);
+        pending.items.clear();
+        pending.bytes = 0;
+        connection->send(frame, kind);
+        return;
+    }
+    if (pending.bytes + bodySize > NetworkConfig::Server::MaxBundleBytes) {
+        sendRuns(pending, false);
+        pending.items.clear();
+        pending.bytes = 0;
+    }
+    pending.items.push_back(Item{frame, kind});
+    pending.bytes += bodySize;
+}
+
+void OutboundBundler::flush() {
+    built_.clear();
+    for (size_t i = 0; i < pendingCount_; ++i) {
+        sendRuns(pending_[i], true);
+    }
+    built_.clear();
+
+    for (size_t i = 0; i < pendingCount_; ++i) {
+        pending_[i].connection.reset();
+        pending_[i].items.clear();
+        pending_[i].bytes = 0;
+    }
+    pendingCount_ = 0;
+}
+
+OutboundBundler::Pending& OutboundBundler::pendingFor(const std::shared_ptr<ClientConnection>& connection) {
+    // A handful of clients per session, a linear scan beats a map here
+    for (size_t i = 0; i < pendingCount_; ++i) {
+        if (pending_[i].connection == connection) {
+            return pending_[i];
+        }
+    }
+    if (pendingCount_ == pending_.size()) {
+        pending_.emplace_back();
+    }
+    Pending& pending = pending_[pendingCount_++];
+    pending.connection = connection;
+    return pending;
+}
+
+void OutboundBundler::sendRuns(Pending& pending, bool shareBundles) {
+    const std::vector<Item>& items = pending.items;
+    size_t first = 0;
+    while (first < items.size()) {
+        const bool reliable = items[first].kind == FrameKind::Reliable;
+        size_t end = first;
+        size_t bytes = 0;
+        while (end < items.size() && (items[end].kind == FrameKind::Reliable) == reliable) {
+            bytes += items[end].frame->size() - FramePrefixSize;
+            ++end;
+        }
+        sendRun(pending.connection, items.data() + first, end - first, bytes, shareBundles);
+        first = end;
+    }
+}
+
+void OutboundBundler::sendRun(const std::shared_ptr<ClientConnection>& connection, const Item* items, size_t count,
+                              size_t bytes, bool shareBundles) {
+    if (count == 1) {
+        connection->send(items[0].frame, items[0].kind);
+        return;
+    }
+    Frame bundle;
+    if (shareBundles) {
+        // Broadcasts usually leave several clients with the same frames, share their bundle
+        for (const Built& built : built_) {
+            if (built.count == count &&
+                std::equal(items, items + count, built.items,
+                           [](const Item& a, const Item& b) { return a.frame == b.frame && a.kind == b.kind; })) {
+                bundle = built.bundle;
+                break;
+            }
+        }
+    }
+    if (!bundle) {
+        bundle = encodeBundle(items, count, bytes);
+        if (shareBundles) {
+            built_.push_back(Built{items, count, bundle});
+        }
+    }
+    connection->send(bundle, bundleKind(items, count));
+}
+
+OutboundBundler::FrameKind OutboundBundler::bundleKind(const Item* items, size_t count) {
+    FrameKind kind = FrameKind::Heartbeat;
+    for (size_t i = 0; i < count; ++i) {
+        if (items[i].kind == FrameKind::Reliable) {
+            return FrameKind::Reliable;
+        }
+        if (items[i].kind == FrameKind::State) {
+            kind = FrameKind::State;
+        }
+    }
+    return kind;
+}
+
+OutboundBundler::Frame OutboundBundler::encodeBundle(const Item* items, size_t count, size_t bytes) {
+    const uint32_t dataSize = static_cast<uint32_t>(bytes);
+    const uint32_t frameSize = static_cast<uint32_t>(BodyHeaderSize + bytes);
+
+    auto frame = framePool_ ? framePool_->acquire(FramePrefixSize + frameSize)
+                            : std::make_shared<std::vector<uint8_t>>();
+    frame->resize(FramePrefixSize + frameSize);
+    uint8_t* out = frame->data();
+    std::memcpy(out, &frameSize, sizeof(frameSize));
+    out += FramePrefixSize;
+
+    // 1. Message type - 1 byte
+    *out++ = static_cast<uint8_t>(MessageType::BUNDLE);
+
+    // 2. Sender ID - 2 bytes, the server
+    *out++ = 0;
+    *out++ = 0;
+
+    // 3. Data length - 4 bytes
+    *out++ = static_cast<uint8_t>((dataSize >> 24) & 0xFF);
+    *out++ = static_cast<uint8_t>((dataSize >> 16) & 0xFF);
+    *out++ = static_cast<uint8_t>((dataSize >> 8) & 0xFF);
+    *out++ = static_cast<uint8_t>(dataSize & 0xFF);
+
+    // 4. The bundled messages, each frame without its size prefix
+    for (size_t i = 0; i < count; ++i) {
+        const size_t bodySize = items[i].frame->size() - FramePrefixSize;
+        std::memcpy(out, items[i].frame->data() + FramePrefixSize, bodySize);
+        out += bodySize;
+    }
+    return frame;
+}
@@ -0,0 +1,272 @@
+#include "network/SnapshotCodec.h"
+#include "network/BitStream.h"
+#include "network/NetworkConfig.h"
+#include "object.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr float PositionScale = static_cast<float>(1 << NetworkConfig::SnapshotPositionFractionBits);
+constexpr float VelocityScale = static_cast<float>(1 << NetworkConfig::SnapshotVelocityFractionBits);
+constexpr int32_t VelocityLimit = (1 << (NetworkConfig::SnapshotVelocityBits - 1)) - 1;
+constexpr unsigned TypeBits = 3;
+constexpr unsigned AxisBitsWidth = 6;
+constexpr unsigned AnimStateBits = 4;
+constexpr unsigned DirectionBits = 3;
+constexpr unsigned TileIndexBits = 8;
+constexpr size_t TypicalObjectBytes = 8; // Initial reservation per object, the writer grows beyond it
+
+// Rounding to the nearest step is off by at most half a step
+static_assert(0.5f / PositionScale < NetworkConfig::Client::PositionErrorThreshold,
+              "Position quantization must stay below the client's reconciliation threshold");
+static_assert(static_cast<int>(ObjectType::MINOTAUR) < (1 << TypeBits), "Object type does not fit its field");
+static_assert(static_cast<int>(AnimationState::CUSTOM) < (1 << AnimStateBits), "Animation state does not fit its field");
+static_assert(static_cast<int>(FacingDirection::SOUTH_EAST) < (1 << DirectionBits), "Direction does not fit its field");
+
+// Positions are kept well inside int32 so frame spans always fit in 32 bits
+int32_t quantizePosition(float value) {
+    constexpr double Limit = static_cast<double>(std::numeric_limits<int32_t>::max() / 2);
+    const double scaled = std::nearbyint(static_cast<double>(value) * PositionScale);
+    if (!(scaled == scaled)) {
+        return 0;  // NaN
+    }
+    return static_cast<int32_t>(std::max(-Limit, std::min(Limit, scaled)));
+}
+
+int32_t quantizeVelocity(float value) {
+    const float scaled = std::nearbyint(value * VelocityScale);
+    if (!(scaled == scaled)) {
+        return 0;
+    }
+    return static_cast<int32_t>(std::max<float>(-VelocityLimit, std::min<float>(VelocityLimit, scaled)));
+}
+
+uint8_t bitWidth(uint32_t value) {
+    uint8_t bits = 0;
+    while (value != 0) {
+        ++bits;
+        value >>= 1;
+    }
+    return bits;
+}
+
+// The three walkers share visitObject below, so sizes, encoder and decoder stay in step
+
+class BitCounter {
+public:
+    explicit BitCounter(const SnapshotCodec::Frame& frame) : frame_(frame) {}
+
+    template <typename T>
+    void bits(const T&, unsigned count) { bits_ += count; }
+    template <typename T>
+    void varint(const T& value) { bits_ += varintBits(static_cast<uint32_t>(value)); }
+    template <typename T>
+    void signedVarint(const T& value) {
+        const int32_t v = static_cast<int32_t>(value);
+        bits_ += varintBits((static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31));
+    }
+    void positionX(const float&) { bits_ += frame_.bitsX; }
+    void positionY(const float&) { bits_ += frame_.bitsY; }
+    void velocity(const float&) { bits_ += NetworkConfig::SnapshotVelocityBits; }
+    bool flag(bool value) { bits_ += 1; return value; }
+    size_t count() const { return bits_; }
+
+private:
+    static size_t varintBits(uint32_t value) {
+        size_t bits = 8;
+        while (value >= 0x80) {
+            bits += 8;
+            value >>= 7;
+        }
+        return bits;
+    }
+
+    const SnapshotCodec::Frame& frame_;
+    size_t bits_ = 0;
+};
+
+class Encoder {
+public:
+    Encoder(BitWriter& writer, const SnapshotCodec::Frame& frame) : frame_(frame), writer_(writer) {}
+
+    template <typename T>
+    void bits(const T& value, unsigned count) { writer_.write(static_cast<uint32_t>(value), count); }
+    template <typename T>
+    void varint(const T& value) { writer_.writeVarint(static_cast<uint32_t>(value)); }
+    template <typename T>
+    void signedVarint(const T& value) { writer_.writeSignedVarint(static_cast<int32_t>(value)); }
+    void positionX(const float& value) {
+        writer_.write(static_cast<uint32_t>(quantizePosition(value) - frame_.originX), frame_.bitsX);
+    }
+    void positionY(const float& value) {
+        writer_.write(static_cast<uint32_t>(quantizePosition(value) - frame_.originY), frame_.bitsY);
+    }
+    void velocity(const float& value) {
+        writer_.write(static_cast<uint32_t>(quantizeVelocity(value)), NetworkConfig::SnapshotVelocityBits);
+    }
+    bool flag(bool value) { writer_.writeFlag(value); return value; }
+
+private:
+    const SnapshotCodec::Frame& frame_;
+    BitWriter& writer_;
+};
+
+class Decoder {
+public:
+    Decoder(BitReader& reader, const SnapshotCodec::Frame& frame)
+        : frame_(frame), reader_(reader) {}
+
+    template <typename T>
+    void bits(T& value, unsigned count) { value = static_cast<T>(reader_.read(count)); }
+    template <typename T>
+    void varint(T& value) { value = static_cast<T>(reader_.readVarint()); }
+    template <typename T>
+    void signedVarint(T& value) { value = static_cast<T>(reader_.readSignedVarint()); }
+    void positionX(float& value) {
+        value = static_cast<float>(static_cast<int64_t>(frame_.originX) + reader_.read(frame_.bitsX)) / PositionScale;
+    }
+    void positionY(float& value) {
+        value = static_cast<float>(static_cast<int64_t>(frame_.originY) + reader_.read(frame_.bitsY)) / PositionScale;
+    }
+    void velocity(float& value) {
+        // Sign-extend the two's complement field
+        constexpr uint32_t SignBit = uint32_t(1) << (NetworkConfig::SnapshotVelocityBits - 1);
+        const uint32_t raw = reader_.read(NetworkConfig::SnapshotVelocityBits);
+        value = static_cast<float>(static_cast<int32_t>(raw ^ SignBit) - static_cast<int32_t>(SignBit)) / VelocityScale;
+    }
+    bool flag(bool) { return reader_.readFlag(); }
+
+private:
+    const SnapshotCodec::Frame& frame_;
+    BitReader& reader_;
+};
+
+template <typename Io, typename Record>
+void visitObject(Io& io, Record& obj) {
+    io.bits(obj.type, TypeBits);
+    io.varint(obj.id);
+    io.positionX(obj.position.x);
+    io.positionY(obj.position.y);
+    if (io.flag(obj.velocity.x != 0.0f || obj.velocity.y != 0.0f)) {
+        io.velocity(obj.velocity.x);
+        io.velocity(obj.velocity.y);
+    }
+    switch (static_cast<ObjectType>(obj.type)) {
+        case ObjectType::PLAYER:
+        case ObjectType::MINOTAUR:
+            io.bits(obj.animState, AnimStateBits);
+            io.bits(obj.direction, DirectionBits);
+            io.signedVarint(obj.health);
+            break;
+        case ObjectType::TILE:
+            io.bits(obj.tileIndex, TileIndexBits);
+            io.varint(obj.flags);
+            io.varint(obj.tilesetIndex);
+            break;
+        default:
+            break;
+    }
+}
+
+template <typename Io>
+void visitFrame(Io& io, SnapshotCodec::Frame& frame) {
+    io.signedVarint(frame.originX);
+    io.signedVarint(frame.originY);
+    io.bits(frame.bitsX, AxisBitsWidth);
+    io.bits(frame.bitsY, AxisBitsWidth);
+}
+}
+
+SnapshotCodec::Frame SnapshotCodec::frameFor(const ObjectSnapshot* const* objects, size_t count) {
+    Frame frame;
+    if (count == 0) {
+        return frame;
+    }
+    int32_t minX = std::numeric_limits<int32_t>::max();
+    int32_t minY = std::numeric_limits<int32_t>::max();
+    int32_t maxX = std::numeric_limits<int32_t>::min();
+    int32_t maxY = std::numeric_limits<int32_t>::min();
+    for (size_t i = 0; i < count; ++i) {
+        const int32_t x = quantizePosition(objects[i]->position.x);
+        const int32_t y = quantizePosition(objects[i]->position.y);
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    frame.originX = minX;
+    frame.originY = minY;
+    frame.bitsX = bitWidth(static_cast<uint32_t>(maxX - minX));
+    frame.bitsY = bitWidth(static_cast<uint32_t>(maxY - minY));
+    return frame;
+}
+
+void SnapshotCodec::encode(const ObjectSnapshotRefs& objects, std::vector<uint8_t>& out) {
+    encode(objects.data(), objects.size(), frameFor(objects.data(), objects.size()), out);
+}
+
+void SnapshotCodec::encode(const ObjectSnapshot* const* objects, size_t count, const Frame& frame,
+                           std::vector<uint8_t>& out) {
+    out.reserve(out.size() + count * TypicalObjectBytes);
+
+    BitWriter writer(out);
+    writer.writeVarint(static_cast<uint32_t>(count));
+    if (count > 0) {
+        Encoder encoder(writer, frame);
+        Frame header = frame;
+        visitFrame(encoder, header);
+        for (size_t i = 0; i < count; ++i) {
+            visitObject(encoder, *objects[i]);
+        }
+    }
+    writer.finish();
+}
+
+size_t SnapshotCodec::headerBits(size_t count, const Frame& frame) {
+    BitCounter counter(frame);
+    counter.varint(count);
+    if (count > 0) {
+        Frame header = frame;
+        visitFrame(counter, header);
+    }
+    return counter.count();
+}
+
+size_t SnapshotCodec::objectBits(const ObjectSnapshot& object, const Frame& frame) {
+    BitCounter counter(frame);
+    visitObject(counter, object);
+    return counter.count();
+}
+
+bool SnapshotCodec::decode(const uint8_t* data, size_t size, std::vector<ObjectSnapshot>& objects) {
+    objects.clear();
+    BitReader reader(data, size);
+    const uint32_t count = reader.readVarint();
+    if (!reader.ok()) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    // Every object takes at least a byte, anything claiming more is corrupt
+    if (count > size) {
+        return false;
+    }
+
+    Frame frame;
+    Decoder decoder(reader, frame);
+    visitFrame(decoder, frame);
+    if (!reader.ok() || frame.bitsX > 32 || frame.bitsY > 32) {
+        return false;
+    }
+    objects.resize(count);
+    for (ObjectSnapshot& obj : objects) {
+        visitObject(decoder, obj);
+        if (!reader.ok()) {
+            objects.clear();
+            return false;
+        }
+    }
+    return true;
+}
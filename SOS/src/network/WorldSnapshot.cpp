@@ -0,0 +1,71 @@
+#include "network/WorldSnapshot.h"
+#include "level.h"
+#include "objects/player.h"
+#include "objects/tile.h"
+#include "objects/minotaur.h"
+
+ObjectSnapshot ObjectSnapshot::fromObject(const Object& obj) {
+    ObjectSnapshot snapshot;
+    snapshot.id = obj.getObjID();
+    snapshot.type = static_cast<uint8_t>(obj.type);
+    snapshot.position = obj.getposition();
+    snapshot.velocity = obj.getvelocity();
+
+    switch (obj.type) {
+        case ObjectType::PLAYER:
+        case ObjectType::MINOTAUR: {
+            const auto& entity = static_cast<const Entity&>(obj);
+            snapshot.animState = static_cast<uint8_t>(entity.getAnimationState());
+            snapshot.direction = static_cast<uint8_t>(entity.getDir());
+            snapshot.health = entity.getHealth();
+            break;
+        }
+        case ObjectType::TILE: {
+            const auto& tile = static_cast<const Tile&>(obj);
+            snapshot.tileIndex = tile.gettileIndex();
+            snapshot.flags = tile.getFlags();
+            snapshot.tilesetIndex = tile.gettilesetIndex();
+            break;
+        }
+        default:
+            break;
+    }
+    return snapshot;
+}
+
+void LevelSnapshot::capture(Level& level, const ClientIds& levelRecipients, const ClientIds& fullStateClients,
+                            bool needDynamic) {
+    levelId = level.getId();
+    recipients.assign(levelRecipients.begin(), levelRecipients.end());
+    fullStateRecipients.assign(fullStateClients.begin(), fullStateClients.end());
+    tilesetNames = level.getTilesetNames();
+    objectCount = level.getObjects().size();
+
+    DirtyTracker& dirty = level.getDirtyTracker();
+    changed.clear();
+    for (uint16_t id : dirty.dirtyIds()) {
+        // Marked objects may have left the level since
+        if (const Object* obj = level.findObject(id)) {
+            changed.push_back(ObjectSnapshot::fromObject(*obj));
+        }
+    }
+    dirty.clear();
+
+    dynamic.clear();
+    dynamicCaptured = needDynamic;
+    if (needDynamic) {
+        for (const auto& obj : level.getDynamicObjects()) {
+            dynamic.push_back(ObjectSnapshot::fromObject(*obj));
+        }
+    }
+
+    objects.clear();
+    if (fullStateRecipients.empty()) {
+        return;
+    }
+    objects.reserve(objectCount);
+    for (const auto& obj : level.getObjects()) {
+        if (!obj) continue;
+        objects.push_back(ObjectSnapshot::fromObject(*obj));
+    }
+}
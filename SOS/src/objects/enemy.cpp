@@ -199,6 +199,7 @@ void Enemy::takeDamage(int16_t amount) {
     if (isDead_) return;
     
     health -= amount;
+    markDirty();
     std::cout << "Enemy " << getObjID() << " took " << amount << " damage! Health: " << health << std::endl;
     
     if (health <= 0) {
@@ -210,7 +211,10 @@ void Enemy::takeDamage(int16_t amount) {
 
 
 void Enemy::setHealth(int16_t newHealth) {
-    health = newHealth;
+    if (health != newHealth) {
+        health = newHealth;
+        markDirty();
+    }
     if (health <= 0) {
         currentState = EnemyState::DYING;
         isDead_ = true;
@@ -42,9 +42,11 @@ void Minotaur::setupAnimations(std::filesystem::path atlasPath)
     animController.setDirectionRow(AnimationState::ATTACKING, FacingDirection::SOUTH, 10,14);
     animController.setDirectionRow(AnimationState::ATTACKING, FacingDirection::EAST, 15,19);
 
-    std::cout << "Setting up healthbar" << std::endl;
-    //Setup healthbar
-    healthbar_ = std::make_unique<Healthbar>(getposition().x, getposition().y - 20, atlasPath / "healthbar.tpsheet", health);
+    //Setup healthbar, headless builds do not draw it
+    if (!AnimationController::isHeadless()) {
+        std::cout << "Setting up healthbar" << std::endl;
+        healthbar_ = std::make_unique<Healthbar>(getposition().x, getposition().y - 20, atlasPath / "healthbar.tpsheet", health);
+    }
     // Set initial state
     setAnimationState(AnimationState::IDLE);
 }
@@ -59,16 +61,16 @@ void Minotaur::move() {
         if (std::abs(velocity.x) > std::abs(velocity.y)) {
             // Horizontal movement is dominant
             if (velocity.x > 0) {
-                dir = FacingDirection::EAST;
+                setDir(FacingDirection::EAST);
             } else {
-                dir = FacingDirection::WEST;
+                setDir(FacingDirection::WEST);
             }
         } else {
             // Vertical movement is dominant
             if (velocity.y > 0) {
-                dir = FacingDirection::SOUTH;
+                setDir(FacingDirection::SOUTH);
             } else {
-                dir = FacingDirection::NORTH;
+                setDir(FacingDirection::NORTH);
             }
         }
     }
@@ -99,16 +101,16 @@ void Minotaur::attack() {
         if (std::abs(direction.x) > std::abs(direction.y)) {
             // Horizontal direction is dominant
             if (direction.x > 0) {
-                dir = FacingDirection::EAST;
+                setDir(FacingDirection::EAST);
             } else {
-                dir = FacingDirection::WEST;
+                setDir(FacingDirection::WEST);
             }
         } else {
             // Vertical direction is dominant
             if (direction.y > 0) {
-                dir = FacingDirection::SOUTH;
+                setDir(FacingDirection::SOUTH);
             } else {
-                dir = FacingDirection::NORTH;
+                setDir(FacingDirection::NORTH);
             }
         }
         
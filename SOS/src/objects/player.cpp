@@ -18,15 +18,19 @@ void Player::setupAnimations() {
     // Parameters: (AnimationState, startFrame, frameCount, framesPerRow, frameTime, loop)
 
     // Example animation setup - adjust these based on your actual sprite sheet
-    std::filesystem::path base = std::filesystem::current_path();
-    std::string temp = base.string();
-    std::size_t pos = temp.find("SagaOfSacrifice2/");
-    if (pos != std::string::npos) {
-        temp = temp.substr(0, pos + std::string("SagaOfSacrifice2/").length());
+    // Headless builds never open the sprite sheets, only their names are needed
+    std::filesystem::path basePath;
+    if (!AnimationController::isHeadless()) {
+        std::filesystem::path base = std::filesystem::current_path();
+        std::string temp = base.string();
+        std::size_t pos = temp.find("SagaOfSacrifice2/");
+        if (pos != std::string::npos) {
+            temp = temp.substr(0, pos + std::string("SagaOfSacrifice2/").length());
+        }
+        basePath = std::filesystem::path(temp);
+        basePath /= "SOS/assets/spriteatlas";
+        std::cout << "Got base path for player" << std::endl;
     }
-    auto basePath = std::filesystem::path(temp);
-    basePath /= "SOS/assets/spriteatlas";
-    std::cout << "Got base path for player" << std::endl;
 
     addSpriteSheet(AnimationState::IDLE, basePath / "wolfman_idle.tpsheet");        // Idle animation (1 frames)
     animController.setDirectionRow(AnimationState::IDLE, FacingDirection::NORTH, 0, 1);
@@ -48,7 +52,9 @@ void Player::setupAnimations() {
     animController.setDirectionRow(AnimationState::ATTACKING, FacingDirection::SOUTH, 10,14);
     animController.setDirectionRow(AnimationState::ATTACKING, FacingDirection::EAST, 15,19);
 
-    healthbar_ = std::make_unique<Healthbar>(getposition().x, getposition().y - 20, basePath / "healthbar.tpsheet", health, false); // Create health bar for player
+    if (!AnimationController::isHeadless()) {
+        healthbar_ = std::make_unique<Healthbar>(getposition().x, getposition().y - 20, basePath / "healthbar.tpsheet", health, false); // Create health bar for player
+    }
     
     // Set initial state
     setAnimationState(AnimationState::IDLE);
@@ -67,8 +73,8 @@ void Player::update(float deltaTime) {
 
     } else {
         // Local player update logic
-        BoxCollider* pColl = &getcollider();
-        Vec2* pos = &pColl->position;
+        const BoxCollider* pColl = &getcollider();
+        const Vec2* pos = &pColl->position;
         Vec2 vel = getvelocity();
 
         // *pos += vel * deltaTime; // Update position based on velocity and delta time
@@ -98,13 +104,13 @@ void Player::update(float deltaTime) {
 // Helper method to update direction based on velocity
 void Player::updateDirectionFromVelocity(const Vec2& vel) {
     if (vel.x > 0) {
-        dir = FacingDirection::EAST;
+        setDir(FacingDirection::EAST);
     } else if (vel.x < 0) {
-        dir = FacingDirection::WEST;
+        setDir(FacingDirection::WEST);
     } else if (vel.y > 0) {
-        dir = FacingDirection::SOUTH;
+        setDir(FacingDirection::SOUTH);
     } else if (vel.y < 0) {
-        dir = FacingDirection::NORTH;
+        setDir(FacingDirection::NORTH);
     }
 }
 
@@ -248,6 +254,7 @@ void Player::accept(CollisionVisitor& visitor) {
 
 void Player::takeDamage(int amount) {
     health -= amount;
+    markDirty();
     if (health <= 0) {
         // Handle player death
         // setAnimationState(AnimationState::DYING);
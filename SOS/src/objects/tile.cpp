@@ -2,23 +2,37 @@
 #include <filesystem>
 #include <iostream>
 
-Tile::Tile(int x, int y, uint16_t objID, std::string tileMap, int tileIndex, int tileWidth, int tileHeight, int columns) :   
+Tile::Tile(int x, int y, uint16_t objID, std::string tileMap, int tileIndex, int tileWidth, int tileHeight, int columns, uint16_t tilesetIndex) :   
         Object(BoxCollider(x, y, tileWidth, tileHeight), 
         ObjectType::TILE, objID), 
         tileIndex(tileIndex), 
-        tileMapName(tileMap) 
+        tileMapName(tileMap),
+        tilesetIndex(tilesetIndex)
 {
     // Initialize Tile-specific attributes here
 }
 
 void Tile::setupAnimations(std::filesystem::path atlasPath)
 {
+    if (AnimationController::isHeadless()) {
+        // Tiles show a fixed sprite, there is no timing to keep
+        addAnimation(AnimationState::IDLE, 1, 0, true);
+        return;
+    }
     std::string fileName = tileMapName + ".tpsheet";
     atlasPath /= fileName;
     addSpriteSheet(AnimationState::IDLE, atlasPath);
     addAnimation(AnimationState::IDLE, 1, 0, true); // Idle animation (1 frame)
 }
 
+void Tile::setupAnimations(SpriteData* spriteSheet)
+{
+    if (spriteSheet) {
+        addSpriteSheet(AnimationState::IDLE, spriteSheet);
+    }
+    addAnimation(AnimationState::IDLE, 1, 0, true); // Idle animation (1 frame)
+}
+
 
 void Tile::update(float deltaTime) {
 
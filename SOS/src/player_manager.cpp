@@ -1,11 +1,6 @@
 #include "player_manager.h"
 
 
-PlayerManager& PlayerManager::getInstance() {
-    static PlayerManager instance;
-    return instance;
-}
-
 std::shared_ptr<Player> PlayerManager::createPlayer(const uint16_t playerId, const Vec2& position) {
     std::lock_guard<std::mutex> lock(playerMutex_);
     
@@ -0,0 +1,106 @@
+#include "utils/LoadController.h"
+#include "network/NetworkConfig.h"
+#include <algorithm>
+#include <iostream>
+
+// Degradation ladder: snapshot rate is shed first since clients interpolate,
+// thinning distant simulation only kicks in when that was not enough
+const LoadController::Step LoadController::Steps[] = {
+    {1, 1},
+    {2, 1},
+    {2, 2},
+    {3, 4},
+};
+const uint32_t LoadController::MaxLevel = sizeof(Steps) / sizeof(Steps[0]) - 1;
+
+LoadController::LoadController(Clock::duration tickPeriod, uint64_t baseSnapshotIntervalMs)
+    : tickPeriod_(tickPeriod),
+      baseSnapshotIntervalMs_(baseSnapshotIntervalMs) {
+}
+
+void LoadController::reset() {
+    windowTicks_ = 0;
+    windowWork_ = Clock::duration::zero();
+    windowPeak_ = Clock::duration::zero();
+    windowOutboundBytes_ = 0;
+    calmWindows_ = 0;
+    if (level_.load(std::memory_order_relaxed) != 0) {
+        setLevel(0);
+    }
+}
+
+void LoadController::recordTick(Clock::duration workTime, size_t outboundBytes) {
+    windowTicks_++;
+    windowWork_ += workTime;
+    windowPeak_ = std::max(windowPeak_, workTime);
+    windowOutboundBytes_ = outboundBytes;
+
+    if (windowTicks_ >= NetworkConfig::Server::LoadEvaluationTicks) {
+        evaluateWindow();
+        windowTicks_ = 0;
+        windowWork_ = Clock::duration::zero();
+        windowPeak_ = Clock::duration::zero();
+    }
+}
+
+void LoadController::evaluateWindow() {
+    const double period = static_cast<double>(tickPeriod_.count());
+    const double utilization = static_cast<double>(windowWork_.count()) / (period * windowTicks_);
+    const double peak = static_cast<double>(windowPeak_.count()) / period;
+    tickUtilization_.store(utilization, std::memory_order_relaxed);
+    peakTickUtilization_.store(peak, std::memory_order_relaxed);
+    outboundBytes_.store(windowOutboundBytes_, std::memory_order_relaxed);
+
+    const uint32_t level = level_.load(std::memory_order_relaxed);
+    const bool overloaded = utilization > NetworkConfig::Server::LoadHighUtilization ||
+                            peak >= 1.0 ||
+                            windowOutboundBytes_ > NetworkConfig::Server::LoadHighOutboundBytes;
+    const bool calm = utilization < NetworkConfig::Server::LoadLowUtilization &&
+                      peak < NetworkConfig::Server::LoadHighUtilization &&
+                      windowOutboundBytes_ < NetworkConfig::Server::LoadLowOutboundBytes;
+
+    if (overloaded) {
+        calmWindows_ = 0;
+        if (level < MaxLevel) {
+            escalations_.fetch_add(1, std::memory_order_relaxed);
+            setLevel(level + 1);
+        }
+    } else if (calm) {
+        if (level > 0 && ++calmWindows_ >= NetworkConfig::Server::LoadRecoveryWindows) {
+            calmWindows_ = 0;
+            recoveries_.fetch_add(1, std::memory_order_relaxed);
+            setLevel(level - 1);
+        }
+    } else {
+        calmWindows_ = 0;
+    }
+}
+
+void LoadController::setLevel(uint32_t level) {
+    level_.store(level, std::memory_order_relaxed);
+    std::cout << "[LoadController] Load level " << level << ": snapshot interval " << getSnapshotIntervalMs()
+              << " ms, distant entities every " << getDistantUpdateStride() << " ticks (tick utilization "
+              << tickUtilization_.load(std::memory_order_relaxed) << ", outbound "
+              << outboundBytes_.load(std::memory_order_relaxed) << " bytes)" << std::endl;
+}
+
+uint64_t LoadController::getSnapshotIntervalMs() const {
+    return baseSnapshotIntervalMs_ * Steps[level_.load(std::memory_order_relaxed)].snapshotIntervalMultiplier;
+}
+
+int LoadController::getDistantUpdateStride() const {
+    return Steps[level_.load(std::memory_order_relaxed)].distantUpdateStride;
+}
+
+LoadController::Metrics LoadController::getMetrics() const {
+    Metrics metrics;
+    metrics.level = level_.load(std::memory_order_relaxed);
+    metrics.snapshotIntervalMs = getSnapshotIntervalMs();
+    metrics.distantUpdateStride = static_cast<uint32_t>(getDistantUpdateStride());
+    metrics.tickUtilization = tickUtilization_.load(std::memory_order_relaxed);
+    metrics.peakTickUtilization = peakTickUtilization_.load(std::memory_order_relaxed);
+    metrics.outboundBytes = outboundBytes_.load(std::memory_order_relaxed);
+    metrics.escalations = escalations_.load(std::memory_order_relaxed);
+    metrics.recoveries = recoveries_.load(std::memory_order_relaxed);
+    return metrics;
+}
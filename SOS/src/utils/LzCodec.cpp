@@ -0,0 +1,159 @@
+#include "utils/LzCodec.h"
+#include <array>
+#include <cstring>
+
+namespace {
+constexpr size_t MinMatch = 4;
+constexpr size_t LastLiterals = 5;   // The block always ends with at least this many literals
+constexpr size_t MatchSearchLimit = 12; // No match starts within this many bytes of the end
+constexpr size_t MaxOffset = 65535;
+constexpr int HashBits = 12;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash(uint32_t word) {
+    return (word * 2654435761u) >> (32 - HashBits);
+}
+
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength,
+                   size_t offset, size_t matchLength) {
+    const size_t matchCode = matchLength - MinMatch;
+    uint8_t token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+    token |= static_cast<uint8_t>(matchCode >= 15 ? 15 : matchCode);
+    out.push_back(token);
+    if (literalLength >= 15) {
+        writeLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        writeLength(out, matchCode - 15);
+    }
+}
+
+bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+}
+
+void LzCodec::compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(maxCompressedSize(size));
+
+    size_t anchor = 0;
+    if (size > MatchSearchLimit) {
+        // Positions + 1 of recently seen words, 0 means empty
+        std::array<uint32_t, 1 << HashBits> table{};
+        const size_t searchEnd = size - MatchSearchLimit;
+        const size_t matchEnd = size - LastLiterals;
+        size_t pos = 0;
+        while (pos < searchEnd) {
+            const uint32_t word = read32(data + pos);
+            uint32_t& slot = table[hash(word)];
+            const size_t candidate = slot;
+            slot = static_cast<uint32_t>(pos + 1);
+            if (candidate == 0 || pos - (candidate - 1) > MaxOffset || read32(data + candidate - 1) != word) {
+                ++pos;
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            // Grow the match backwards into the pending literals, then forwards
+            while (pos > anchor && ref > 0 && data[pos - 1] == data[ref - 1]) {
+                --pos;
+                --ref;
+            }
+            size_t length = MinMatch;
+            while (pos + length < matchEnd && data[pos + length] == data[ref + length]) {
+                ++length;
+            }
+
+            writeSequence(out, data + anchor, pos - anchor, pos - ref, length);
+            pos += length;
+            anchor = pos;
+            // Remember a position inside the match so repeated records chain up
+            if (pos - 2 < searchEnd) {
+                table[hash(read32(data + pos - 2))] = static_cast<uint32_t>(pos - 2 + 1);
+            }
+        }
+    }
+
+    // Trailing literals without a match
+    const size_t literalLength = size - anchor;
+    out.push_back(static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4));
+    if (literalLength >= 15) {
+        writeLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), data + anchor, data + size);
+}
+
+bool LzCodec::decompress(const uint8_t* data, size_t size, uint8_t* out, size_t originalSize) {
+    const uint8_t* in = data;
+    const uint8_t* end = data + size;
+    size_t written = 0;
+
+    while (in < end) {
+        const uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(in, end, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(end - in) || literalLength > originalSize - written) {
+            return false;
+        }
+        // out may be null when originalSize is 0
+        if (literalLength > 0) {
+            std::memcpy(out + written, in, literalLength);
+        }
+        in += literalLength;
+        written += literalLength;
+
+        // The last sequence has no match
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        const size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += MinMatch;
+        if (offset == 0 || offset > written || matchLength > originalSize - written) {
+            return false;
+        }
+        // Byte by byte, matches may overlap the bytes they produce
+        const uint8_t* match = out + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out[written + i] = match[i];
+        }
+        written += matchLength;
+    }
+    return written == originalSize;
+}
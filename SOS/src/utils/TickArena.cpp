@@ -0,0 +1,56 @@
+#include "utils/TickArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+TickArena::TickArena(size_t initialBytes) {
+    addBlock(initialBytes);
+}
+
+TickArena::~TickArena() {
+    releaseBlocks();
+}
+
+void TickArena::reset() {
+    highWater_ = std::max(highWater_, used_);
+    used_ = 0;
+    offset_ = 0;
+    if (blocks_.size() > 1) {
+        // The tick outgrew the first block, next time it all fits in one
+        size_t total = 0;
+        for (const Block& block : blocks_) {
+            total += block.size;
+        }
+        releaseBlocks();
+        addBlock(total);
+    }
+}
+
+void* TickArena::do_allocate(size_t bytes, size_t alignment) {
+    auto alignedOffset = [&]() {
+        const auto base = reinterpret_cast<uintptr_t>(blocks_.back().data);
+        return static_cast<size_t>(((base + offset_ + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base);
+    };
+    size_t start = alignedOffset();
+    if (start + bytes > blocks_.back().size) {
+        addBlock(bytes + alignment);
+        start = alignedOffset();
+    }
+    used_ += start - offset_ + bytes;
+    offset_ = start + bytes;
+    return blocks_.back().data + start;
+}
+
+void TickArena::addBlock(size_t minimumBytes) {
+    // Doubling keeps the number of blocks of a first, unusually large tick small
+    const size_t size = std::max(minimumBytes, blocks_.empty() ? size_t(0) : blocks_.back().size * 2);
+    blocks_.push_back(Block{static_cast<std::byte*>(::operator new(size)), size});
+    offset_ = 0;
+}
+
+void TickArena::releaseBlocks() {
+    for (const Block& block : blocks_) {
+        ::operator delete(block.data);
+    }
+    blocks_.clear();
+}
@@ -0,0 +1,140 @@
+#include "utils/TickProfiler.h"
+
+namespace {
+
+// Index of the highest set bit, value must be non-zero
+int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucketIndex(uint64_t micros) {
+    if (micros < SubBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    int exponent = highestBit(micros);
+    if (exponent > MaxExponent) {
+        return BucketCount - 1;
+    }
+    uint64_t sub = (micros >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+    return SubBuckets + (exponent - SubBucketBits) * SubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SubBuckets) {
+        return index;
+    }
+    size_t exponent = (index - SubBuckets) / SubBuckets + SubBucketBits;
+    uint64_t sub = (index - SubBuckets) % SubBuckets;
+    return ((SubBuckets + sub + 1) << (exponent - SubBucketBits)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    buckets_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (micros > current &&
+           !max_.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    // Sum the buckets rather than trusting count_, which may be ahead of them
+    std::array<uint64_t, BucketCount> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BucketCount; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(p * total);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint64_t bound = bucketUpperBound(i);
+            uint64_t observedMax = max();
+            return bound < observedMax ? bound : observedMax;
+        }
+    }
+    return max();
+}
+
+void TickProfiler::record(TickPhase phase, std::chrono::steady_clock::duration elapsed) {
+    size_t index = static_cast<size_t>(phase);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    pendingNanos_[index].fetch_add(static_cast<uint64_t>(nanos), std::memory_order_relaxed);
+    pendingTouched_[index].store(true, std::memory_order_relaxed);
+}
+
+void TickProfiler::endTick() {
+    commitPhases(0, FirstSenderPhase);
+}
+
+void TickProfiler::commitSenderPass() {
+    commitPhases(FirstSenderPhase, PhaseCount);
+}
+
+void TickProfiler::commitPhases(size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        // Time first: a record() landing in between then still counts, here or next time
+        uint64_t nanos = pendingNanos_[i].exchange(0, std::memory_order_relaxed);
+        bool touched = pendingTouched_[i].exchange(false, std::memory_order_relaxed);
+        // Phases that did not run (e.g. no state send) are not recorded as zero
+        if (!touched && nanos == 0) {
+            continue;
+        }
+        histograms_[i].record(nanos / 1000);
+    }
+}
+
+TickProfiler::PhaseStats TickProfiler::getPhaseStats(TickPhase phase) const {
+    const auto& histogram = histograms_[static_cast<size_t>(phase)];
+    PhaseStats stats;
+    stats.samples = histogram.count();
+    stats.p50Micros = histogram.percentile(0.50);
+    stats.p99Micros = histogram.percentile(0.99);
+    stats.maxMicros = histogram.max();
+    return stats;
+}
+
+void TickProfiler::reset() {
+    for (size_t i = 0; i < PhaseCount; ++i) {
+        histograms_[i].reset();
+        pendingNanos_[i].store(0, std::memory_order_relaxed);
+        pendingTouched_[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+const char* TickProfiler::phaseName(TickPhase phase) {
+    switch (phase) {
+        case TickPhase::Tick:           return "tick";
+        case TickPhase::LevelUpdate:    return "level update";
+        case TickPhase::ObjectUpdate:   return "object update";
+        case TickPhase::Collision:      return "collision";
+        case TickPhase::Snapshot:       return "snapshot";
+        case TickPhase::CollectObjects: return "collect objects";
+        case TickPhase::Serialization:  return "serialization";
+        case TickPhase::SocketFanout:   return "socket fan-out";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,64 @@
+#include "utils/TickScheduler.h"
+#include <thread>
+
+TickScheduler::TickScheduler(int tickRate, int maxCatchUpTicks)
+    : period_(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate))),
+      fixedDeltaSeconds_(1.0f / tickRate),
+      maxCatchUpTicks_(maxCatchUpTicks) {
+    reset();
+}
+
+void TickScheduler::reset() {
+    nextDeadline_ = Clock::now();
+    windowStart_ = nextDeadline_;
+    windowTicks_ = 0;
+    behind_ = false;
+}
+
+void TickScheduler::waitForNextTick() {
+    if (Clock::now() < nextDeadline_) {
+        std::this_thread::sleep_until(nextDeadline_);
+    }
+}
+
+void TickScheduler::endTick() {
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+    windowTicks_++;
+    nextDeadline_ += period_;
+
+    const auto now = Clock::now();
+    if (now > nextDeadline_) {
+        // One missed deadline is one overrun, however many ticks it takes to catch up
+        if (!behind_) {
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            behind_ = true;
+        }
+
+        // Whole periods we are behind; only a bounded number is replayed
+        const auto behind = static_cast<uint64_t>((now - nextDeadline_) / period_);
+        if (behind > static_cast<uint64_t>(maxCatchUpTicks_)) {
+            const uint64_t skipped = behind - maxCatchUpTicks_;
+            nextDeadline_ += period_ * skipped;
+            skippedTicks_.fetch_add(skipped, std::memory_order_relaxed);
+        }
+    } else {
+        behind_ = false;
+    }
+
+    const auto windowLength = now - windowStart_;
+    if (windowLength >= std::chrono::seconds(1)) {
+        const double seconds = std::chrono::duration<double>(windowLength).count();
+        measuredTickRate_.store(windowTicks_ / seconds, std::memory_order_relaxed);
+        windowStart_ = now;
+        windowTicks_ = 0;
+    }
+}
+
+TickScheduler::Stats TickScheduler::getStats() const {
+    Stats stats;
+    stats.ticks = ticks_.load(std::memory_order_relaxed);
+    stats.overruns = overruns_.load(std::memory_order_relaxed);
+    stats.skippedTicks = skippedTicks_.load(std::memory_order_relaxed);
+    stats.measuredTickRate = measuredTickRate_.load(std::memory_order_relaxed);
+    return stats;
+}
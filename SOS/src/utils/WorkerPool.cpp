@@ -0,0 +1,87 @@
+#include "utils/WorkerPool.h"
+#include <iostream>
+
+WorkerPool::WorkerPool(size_t threadCount) {
+    if (threadCount == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 0;
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& job) {
+    if (count == 0) {
+        return;
+    }
+
+    // Nothing to fan out, skip the hand-off
+    if (count == 1 || workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                job(i);
+            } catch (const std::exception& e) {
+                std::cerr << "[WorkerPool] Job " << i << " failed: " << e.what() << std::endl;
+            }
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = &job;
+    jobCount_ = count;
+    nextIndex_ = 0;
+    pending_ = count;
+    batchId_++;
+    workAvailable_.notify_all();
+
+    // The caller works too instead of idling
+    runJobs(lock);
+    batchDone_.wait(lock, [this]() { return pending_ == 0; });
+    job_ = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t seenBatch = 0;
+    while (true) {
+        workAvailable_.wait(lock, [&]() { return stopping_ || batchId_ != seenBatch; });
+        if (stopping_) {
+            return;
+        }
+        seenBatch = batchId_;
+        runJobs(lock);
+    }
+}
+
+void WorkerPool::runJobs(std::unique_lock<std::mutex>& lock) {
+    while (job_ && nextIndex_ < jobCount_) {
+        size_t index = nextIndex_++;
+        const auto* job = job_;
+        lock.unlock();
+        try {
+            (*job)(index);
+        } catch (const std::exception& e) {
+            std::cerr << "[WorkerPool] Job " << index << " failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+        if (--pending_ == 0) {
+            batchDone_.notify_all();
+        }
+    }
+}
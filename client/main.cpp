@@ -34,6 +34,7 @@ void printUsage(const char* programName) {
     std::cout << "  -s, --server <serverAddress>  Specify server address (default: localhost)" << std::endl;
     std::cout << "  -p, --port <port>             Specify server port (default: 8080)" << std::endl;
     std::cout << "  -id, --playerid <id>          Specify player ID (default: random)" << std::endl;
+    std::cout << "  -L, --level <levelId>         Level to join on the multiplayer server (default: server's level)" << std::endl;
     std::cout << "  -l, --local                   Run in local-only mode without server (for development)" << std::endl;
     std::cout << "  -d, --debug                   Just load in an image and quit. For debugging purposes" << std::endl;
 }
@@ -63,6 +64,7 @@ int main(int argc, char *argv[]) {
     std::string serverAddress = "localhost";
     int serverPort = 8080;
     std::string playerId = generateRandomPlayerId();
+    std::string levelId;
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -96,6 +98,10 @@ int main(int argc, char *argv[]) {
             if (i + 1 < argc) {
                 playerId = argv[++i];
             }
+        } else if (arg == "-L" || arg == "--level") {
+            if (i + 1 < argc) {
+                levelId = argv[++i];
+            }
         } else if (arg == "-d" || arg == "--debug") {
             debugMode = true;
             std::cout << "Debug mode enabled. Loading image and quitting." << std::endl;
@@ -164,7 +170,7 @@ int main(int argc, char *argv[]) {
     // Initialize network features based on mode
     if (enableRemoteMultiplayer) {
         // Connect to remote server for multiplayer
-        if (!game.initializeServerConnection(serverAddress, serverPort, playerId)) {
+        if (!game.initializeServerConnection(serverAddress, serverPort, playerId, levelId)) {
             std::cerr << "Failed to initialize multiplayer. Continuing in single player mode." << std::endl;
         } else {
             std::cout << "Multiplayer initialized successfully!" << std::endl;
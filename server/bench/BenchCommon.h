@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "network/WireSchema.h"
+#include "network/WorldSnapshot.h"
+#include "object.h"
+
+/**
+ * Synthetic level state and timing shared by the benchmarks. The level is a
+ * grid of 32 px tiles shaped like the shipped maps (walls around the edge,
+ * a few floor variants, three tilesets) with players and minotaurs spread
+ * over it, so sizes and timings are comparable between runs and machines
+ * without loading assets.
+ */
+namespace bench {
+
+constexpr int TileSize = 32;
+
+inline std::vector<ObjectSnapshot> makeLevel(int width, int height, int players, int minotaurs) {
+    std::vector<ObjectSnapshot> objects;
+    objects.reserve(static_cast<size_t>(width) * height + players + minotaurs);
+    uint16_t nextId = 0;
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; ++col) {
+            const bool wall = row == 0 || col == 0 || row == height - 1 || col == width - 1;
+            ObjectSnapshot tile;
+            tile.id = nextId++;
+            tile.type = static_cast<uint8_t>(ObjectType::TILE);
+            tile.position = Vec2(static_cast<float>(col * TileSize), static_cast<float>(row * TileSize));
+            tile.tileIndex = static_cast<uint8_t>(wall ? 40 + (row + col) % 4 : (row * 7 + col * 3) % 5);
+            tile.flags = wall ? 1 : 0;
+            tile.tilesetIndex = static_cast<uint16_t>(wall ? 2 : (row / 10) % 2);
+            objects.push_back(tile);
+        }
+    }
+    auto addActor = [&](ObjectType type, int index, int16_t health) {
+        ObjectSnapshot actor;
+        actor.id = nextId++;
+        actor.type = static_cast<uint8_t>(type);
+        actor.position = Vec2(TileSize + (index * 997 % ((width - 2) * TileSize)) + 0.37f * index,
+                              TileSize + (index * 613 % ((height - 2) * TileSize)) + 0.81f * index);
+        actor.animState = static_cast<uint8_t>(index % 3);
+        actor.direction = static_cast<uint8_t>(index % 8);
+        actor.health = health;
+        objects.push_back(actor);
+    };
+    for (int i = 0; i < players; ++i) {
+        addActor(ObjectType::PLAYER, i, 100);
+    }
+    for (int i = 0; i < minotaurs; ++i) {
+        addActor(ObjectType::MINOTAUR, players + i, 300);
+    }
+    return objects;
+}
+
+// Give the players and minotaurs a velocity, as during play
+inline void setMoving(std::vector<ObjectSnapshot>& objects) {
+    int index = 0;
+    for (ObjectSnapshot& obj : objects) {
+        if (static_cast<ObjectType>(obj.type) != ObjectType::TILE) {
+            obj.velocity = Vec2(120.0f - 17.5f * (index % 9), -60.0f + 11.25f * (index % 7));
+            ++index;
+        }
+    }
+}
+
+inline ObjectSnapshotRefs refsTo(const std::vector<ObjectSnapshot>& objects) {
+    ObjectSnapshotRefs refs;
+    refs.reserve(objects.size());
+    for (const ObjectSnapshot& obj : objects) {
+        refs.push_back(&obj);
+    }
+    return refs;
+}
+
+// The float records of a GAME_STATE before SnapshotCodec: [count u16] then a WireSchema record per object
+inline void encodeRecords(const ObjectSnapshotRefs& objects, std::vector<uint8_t>& out) {
+    size_t size = sizeof(uint16_t);
+    for (const ObjectSnapshot* obj : objects) {
+        size += WireSchema::encodedSize(*obj);
+    }
+    out.resize(size);
+    uint8_t* p = out.data();
+    WireSchema::storeLittleEndian(p, static_cast<uint16_t>(objects.size()));
+    p += sizeof(uint16_t);
+    for (const ObjectSnapshot* obj : objects) {
+        p = WireSchema::encode(*obj, p);
+    }
+}
+
+// Median wall time of fn over runs calls, in microseconds
+template <typename Fn>
+double medianMicros(int runs, Fn&& fn) {
+    std::vector<double> samples;
+    samples.reserve(runs);
+    for (int i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+// Repetitions from the first command line argument
+inline int runsFromArgs(int argc, char** argv, int fallback) {
+    const int runs = argc > 1 ? std::atoi(argv[1]) : fallback;
+    return runs > 0 ? runs : fallback;
+}
+
+}
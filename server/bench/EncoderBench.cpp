@@ -0,0 +1,108 @@
+#include "BenchCommon.h"
+#include "network/SnapshotCodec.h"
+#include <cstdio>
+#include <vector>
+
+/**
+ * Time to encode and decode a game state with the WireSchema records
+ * against the per-byte push_back encoder they replaced, with SnapshotCodec
+ * for reference. The legacy encoder below reproduces the old
+ * EmbeddedServer::serializeObject, with the tileset index in place of the
+ * tileset name that WireSchema records no longer carry.
+ * Usage: EncoderBench [runs]
+ */
+namespace {
+
+void legacySerializeObject(const ObjectSnapshot& obj, std::vector<uint8_t>& data) {
+    data.push_back(obj.type);
+    data.push_back(static_cast<uint8_t>(obj.id & 0xFF));
+    data.push_back(static_cast<uint8_t>((obj.id >> 8) & 0xFF));
+
+    auto writeFloat = [&](float v) {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&v);
+        for (size_t i = 0; i < sizeof(float); ++i)
+            data.push_back(bytes[i]);
+    };
+    writeFloat(obj.position.x);
+    writeFloat(obj.position.y);
+    writeFloat(obj.velocity.x);
+    writeFloat(obj.velocity.y);
+
+    switch (static_cast<ObjectType>(obj.type)) {
+        case ObjectType::TILE:
+            data.push_back(obj.tileIndex);
+            for (int i = 0; i < 4; ++i) {
+                data.push_back(static_cast<uint8_t>((obj.flags >> (i * 8)) & 0xFF));
+            }
+            data.push_back(static_cast<uint8_t>(obj.tilesetIndex & 0xFF));
+            data.push_back(static_cast<uint8_t>(obj.tilesetIndex >> 8));
+            break;
+        case ObjectType::MINOTAUR:
+        case ObjectType::PLAYER:
+            data.push_back(obj.animState);
+            data.push_back(obj.direction);
+            data.push_back(static_cast<uint8_t>(obj.health >> 8));
+            data.push_back(static_cast<uint8_t>(obj.health & 0xFF));
+            break;
+        default:
+            break;
+    }
+}
+
+void legacyEncode(const ObjectSnapshotRefs& objects, std::vector<uint8_t>& data) {
+    const uint16_t count = static_cast<uint16_t>(objects.size());
+    data.push_back(static_cast<uint8_t>(count >> 8));
+    data.push_back(static_cast<uint8_t>(count & 0xFF));
+    for (const ObjectSnapshot* obj : objects) {
+        legacySerializeObject(*obj, data);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    const int runs = bench::runsFromArgs(argc, argv, 500);
+    const int objectCounts[] = {300, 3000, 15000};
+
+    std::printf("Game state encoders, median of %d runs (bytes, us)\n", runs);
+    std::printf("%8s %-16s %9s %9s %9s %9s\n", "objects", "encoder", "bytes", "encode", "decode", "ns/object");
+    for (int target : objectCounts) {
+        const int width = target >= 15000 ? 150 : target >= 3000 ? 60 : 20;
+        const int height = target / width;
+        std::vector<ObjectSnapshot> objects = bench::makeLevel(width, height, 4, 20);
+        bench::setMoving(objects);
+        const ObjectSnapshotRefs refs = bench::refsTo(objects);
+        const double count = static_cast<double>(objects.size());
+
+        std::vector<uint8_t> data;
+        std::vector<ObjectSnapshot> decoded;
+
+        const double legacy = bench::medianMicros(runs, [&] {
+            data = std::vector<uint8_t>();  // The old path started from an empty message every time
+            legacyEncode(refs, data);
+        });
+        std::printf("%8zu %-16s %9zu %9.1f %9s %9.1f\n", objects.size(), "legacy push_back", data.size(), legacy,
+                    "-", legacy * 1000.0 / count);
+
+        const double schema = bench::medianMicros(runs, [&] { bench::encodeRecords(refs, data); });
+        const double schemaDecode = bench::medianMicros(runs, [&] {
+            decoded.resize(WireSchema::loadLittleEndian<uint16_t>(data.data()));
+            size_t pos = sizeof(uint16_t);
+            for (ObjectSnapshot& obj : decoded) {
+                WireSchema::decode(data.data(), data.size(), pos, obj);
+            }
+        });
+        std::printf("%8zu %-16s %9zu %9.1f %9.1f %9.1f\n", objects.size(), "WireSchema", data.size(), schema,
+                    schemaDecode, schema * 1000.0 / count);
+
+        const double packed = bench::medianMicros(runs, [&] {
+            data.clear();
+            SnapshotCodec::encode(refs, data);
+        });
+        const double packedDecode =
+            bench::medianMicros(runs, [&] { SnapshotCodec::decode(data.data(), data.size(), decoded); });
+        std::printf("%8zu %-16s %9zu %9.1f %9.1f %9.1f\n", objects.size(), "SnapshotCodec", data.size(), packed,
+                    packedDecode, packed * 1000.0 / count);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "BenchCommon.h"
+#include "network/SnapshotCodec.h"
+#include "utils/LzCodec.h"
+#include <cstdio>
+#include <vector>
+
+/**
+ * Bytes and latency of the full state a joining client receives: the
+ * encoded level, compressed when the client accepts it (see
+ * NetworkConfig::Server::CompressStateMinBytes), then decompressed and
+ * decoded on the client. Network transfer time is not included.
+ * Usage: JoinBench [runs]
+ */
+namespace {
+
+struct JoinCost {
+    size_t rawBytes = 0;
+    size_t compressedBytes = 0;
+    double encodeMicros = 0;
+    double compressMicros = 0;
+    double decompressMicros = 0;
+    double decodeMicros = 0;
+};
+
+template <typename Encode, typename Decode>
+JoinCost measure(int runs, Encode&& encode, Decode&& decode) {
+    JoinCost cost;
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> compressed;
+    std::vector<uint8_t> restored;
+
+    cost.encodeMicros = bench::medianMicros(runs, [&] { raw.clear(); encode(raw); });
+    cost.compressMicros = bench::medianMicros(runs, [&] { LzCodec::compress(raw.data(), raw.size(), compressed); });
+    restored.resize(raw.size());
+    cost.decompressMicros = bench::medianMicros(runs, [&] {
+        LzCodec::decompress(compressed.data(), compressed.size(), restored.data(), restored.size());
+    });
+    cost.decodeMicros = bench::medianMicros(runs, [&] { decode(restored); });
+    cost.rawBytes = raw.size();
+    cost.compressedBytes = compressed.size();
+    if (restored != raw) {
+        std::printf("warning: compressed state did not round trip\n");
+    }
+    return cost;
+}
+
+void print(const char* name, const JoinCost& cost) {
+    std::printf("%-14s %9zu %9zu %7.2fx %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, cost.rawBytes, cost.compressedBytes,
+                static_cast<double>(cost.rawBytes) / cost.compressedBytes, cost.encodeMicros, cost.compressMicros,
+                cost.decompressMicros, cost.decodeMicros,
+                cost.encodeMicros + cost.compressMicros + cost.decompressMicros + cost.decodeMicros);
+}
+
+}
+
+int main(int argc, char** argv) {
+    const int runs = bench::runsFromArgs(argc, argv, 200);
+    const struct {
+        int width, height, players, minotaurs;
+    } levels[] = {{20, 15, 2, 4}, {60, 50, 4, 20}, {150, 100, 8, 60}};
+
+    std::printf("Full state on join, median of %d runs (bytes, us)\n", runs);
+    for (const auto& shape : levels) {
+        const std::vector<ObjectSnapshot> objects =
+            bench::makeLevel(shape.width, shape.height, shape.players, shape.minotaurs);
+        const ObjectSnapshotRefs refs = bench::refsTo(objects);
+        std::printf("\n%zu objects (%dx%d tiles, %d players, %d minotaurs)\n", objects.size(), shape.width,
+                    shape.height, shape.players, shape.minotaurs);
+        std::printf("%-14s %9s %9s %8s %9s %9s %9s %9s %9s\n", "encoding", "raw", "lz", "ratio", "encode",
+                    "compress", "inflate", "decode", "total");
+
+        std::vector<ObjectSnapshot> decoded;
+        print("float records", measure(
+            runs, [&](std::vector<uint8_t>& out) { bench::encodeRecords(refs, out); },
+            [&](const std::vector<uint8_t>& in) {
+                decoded.resize(WireSchema::loadLittleEndian<uint16_t>(in.data()));
+                size_t pos = sizeof(uint16_t);
+                for (ObjectSnapshot& obj : decoded) {
+                    WireSchema::decode(in.data(), in.size(), pos, obj);
+                }
+            }));
+        print("packed", measure(
+            runs, [&](std::vector<uint8_t>& out) { SnapshotCodec::encode(refs, out); },
+            [&](const std::vector<uint8_t>& in) { SnapshotCodec::decode(in.data(), in.size(), decoded); }));
+    }
+    return 0;
+}
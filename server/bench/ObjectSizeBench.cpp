@@ -0,0 +1,108 @@
+#include "BenchCommon.h"
+#include "network/NetworkConfig.h"
+#include "network/SnapshotCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Bytes per object of the packed SnapshotCodec encoding against the float
+ * records of WireSchema, per object type and for whole payloads: the full
+ * state of a level on join and a delta holding only its moving actors.
+ * Also reports the largest position error after the round trip, which must
+ * stay below NetworkConfig::Client::PositionErrorThreshold.
+ * Usage: ObjectSizeBench
+ */
+namespace {
+
+struct PayloadSize {
+    size_t objects = 0;
+    size_t packedBytes = 0;
+    size_t recordBytes = 0;
+    float maxPositionError = 0.0f;
+};
+
+PayloadSize measure(const std::vector<ObjectSnapshot>& objects) {
+    PayloadSize size;
+    const ObjectSnapshotRefs refs = bench::refsTo(objects);
+    std::vector<uint8_t> data;
+    SnapshotCodec::encode(refs, data);
+    size.objects = objects.size();
+    size.packedBytes = data.size();
+
+    std::vector<ObjectSnapshot> decoded;
+    if (SnapshotCodec::decode(data.data(), data.size(), decoded) && decoded.size() == objects.size()) {
+        for (size_t i = 0; i < objects.size(); ++i) {
+            size.maxPositionError = std::max({size.maxPositionError,
+                                              std::fabs(decoded[i].position.x - objects[i].position.x),
+                                              std::fabs(decoded[i].position.y - objects[i].position.y)});
+        }
+    } else {
+        size.maxPositionError = INFINITY;
+    }
+
+    bench::encodeRecords(refs, data);
+    size.recordBytes = data.size();
+    return size;
+}
+
+void printPayload(const char* name, const PayloadSize& size) {
+    const double count = static_cast<double>(std::max<size_t>(size.objects, 1));
+    std::printf("%-22s %8zu %9zu %9zu %8.2f %8.2f %9.4f\n", name, size.objects, size.recordBytes, size.packedBytes,
+                size.recordBytes / count, size.packedBytes / count, size.maxPositionError);
+}
+
+}
+
+int main() {
+    std::vector<ObjectSnapshot> level = bench::makeLevel(60, 50, 4, 20);
+    bench::setMoving(level);
+    const ObjectSnapshotRefs refs = bench::refsTo(level);
+    const SnapshotCodec::Frame frame = SnapshotCodec::frameFor(refs.data(), refs.size());
+
+    std::printf("Per object in a %zu object level (bytes)\n", level.size());
+    std::printf("%-22s %9s %9s\n", "object", "record", "packed");
+    auto printObject = [&](const char* name, const ObjectSnapshot& obj) {
+        std::printf("%-22s %9zu %9.2f\n", name, WireSchema::encodedSize(obj),
+                    SnapshotCodec::objectBits(obj, frame) / 8.0);
+    };
+    for (const ObjectSnapshot& obj : level) {
+        if (static_cast<ObjectType>(obj.type) == ObjectType::TILE) {
+            printObject("tile", obj);
+            break;
+        }
+    }
+    for (const ObjectSnapshot& obj : level) {
+        if (static_cast<ObjectType>(obj.type) == ObjectType::PLAYER) {
+            ObjectSnapshot resting = obj;
+            resting.velocity = Vec2();
+            printObject("player at rest", resting);
+            printObject("player moving", obj);
+            break;
+        }
+    }
+    for (const ObjectSnapshot& obj : level) {
+        if (static_cast<ObjectType>(obj.type) == ObjectType::MINOTAUR) {
+            printObject("minotaur moving", obj);
+            break;
+        }
+    }
+
+    std::vector<ObjectSnapshot> actors;
+    for (const ObjectSnapshot& obj : level) {
+        if (static_cast<ObjectType>(obj.type) != ObjectType::TILE) {
+            actors.push_back(obj);
+        }
+    }
+    std::vector<ObjectSnapshot> pair(actors.begin(), actors.begin() + 2);
+
+    std::printf("\nWhole payloads (bytes, max position error in pixels, threshold %.1f)\n",
+                NetworkConfig::Client::PositionErrorThreshold);
+    std::printf("%-22s %8s %9s %9s %8s %8s %9s\n", "payload", "objects", "records", "packed", "rec/obj", "pack/obj",
+                "max error");
+    printPayload("full state on join", measure(level));
+    printPayload("delta, moving actors", measure(actors));
+    printPayload("delta, two actors", measure(pair));
+    return 0;
+}
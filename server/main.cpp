@@ -3,13 +3,15 @@
 #include <chrono>
 #include <thread>
 #include <filesystem>
-#include "network/EmbeddedServer.h"
+#include "network/LobbyRouter.h"
+#include "network/NetworkConfig.h"
+#include "animation.h"
 
 // Default server port
 const int DEFAULT_PORT = 8282;
 
 // Global pointer to server for signal handler
-std::unique_ptr<EmbeddedServer> g_server;
+std::unique_ptr<LobbyRouter> g_server;
 
 // Signal handler for graceful shutdown
 void signalHandler(int signal) {
@@ -20,8 +22,9 @@ void signalHandler(int signal) {
 }
 
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " [port]" << std::endl;
+    std::cout << "Usage: " << programName << " [port] [io_threads]" << std::endl;
     std::cout << "  port: Optional port number (default: " << DEFAULT_PORT << ")" << std::endl;
+    std::cout << "  io_threads: Optional number of network threads per session (default: " << NetworkConfig::Server::LobbySessionIoThreads << ")" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -47,6 +50,19 @@ int main(int argc, char* argv[]) {
             }
         }
         
+        int ioThreads = NetworkConfig::Server::LobbySessionIoThreads;
+        if (argc > 2) {
+            try {
+                ioThreads = std::stoi(argv[2]);
+                if (ioThreads < 1) {
+                    std::cerr << "Invalid IO thread count. Using default of " << NetworkConfig::Server::LobbySessionIoThreads << std::endl;
+                    ioThreads = NetworkConfig::Server::LobbySessionIoThreads;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Invalid IO thread argument. Using default of " << NetworkConfig::Server::LobbySessionIoThreads << std::endl;
+            }
+        }
+        
         // Register signal handlers
         std::signal(SIGINT, signalHandler);
         std::signal(SIGTERM, signalHandler);
@@ -60,9 +76,13 @@ int main(int argc, char* argv[]) {
         }
         std::cout << "Using base path: " << basePath.string() << std::endl;
 
-        // Create and start server
+        // The dedicated server never renders, skip loading sprite sheets
+        AnimationController::setHeadless(true);
+
+        // Create and start the lobby, it spreads players over game sessions
         std::cout << "Initializing server on port " << port << std::endl;
-        g_server = std::make_unique<EmbeddedServer>(port, basePath);
+        g_server = std::make_unique<LobbyRouter>(port, basePath);
+        g_server->setSessionIoThreadCount(ioThreads);
         g_server->start();
         
         std::cout << "Server running on port " << port << std::endl;
@@ -0,0 +1,77 @@
+#include "utils/BufferPool.h"
+#include "TestCheck.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+void testAcquireHasRequestedSize() {
+    BufferPool pool;
+    BufferPool::Buffer buffer = pool.acquire(100);
+    CHECK(buffer.size() == 100);
+    CHECK(pool.acquire(0).empty());
+}
+
+void testReleasedCapacityIsReused() {
+    BufferPool pool;
+    BufferPool::Buffer buffer = pool.acquire(1000);
+    const uint8_t* data = buffer.data();
+    pool.release(std::move(buffer));
+
+    BufferPool::Buffer again = pool.acquire(10);
+    CHECK(again.size() == 10);
+    CHECK(again.capacity() >= 1000);
+    CHECK(again.data() == data);
+}
+
+void testLargeBuffersAreNotRetained() {
+    BufferPool pool(4, 1024);
+    BufferPool::Buffer buffer = pool.acquire(4096);
+    pool.release(std::move(buffer));
+    CHECK(pool.acquire(10).capacity() < 4096);
+}
+
+void testPoolSizeIsBounded() {
+    BufferPool pool(2, 1024);
+    std::vector<BufferPool::Buffer> buffers;
+    for (int i = 0; i < 4; ++i) {
+        buffers.push_back(pool.acquire(100));
+    }
+    for (BufferPool::Buffer& buffer : buffers) {
+        pool.release(std::move(buffer));
+    }
+    // Only two were kept, the third acquire allocates
+    CHECK(pool.acquire(1).capacity() >= 100);
+    CHECK(pool.acquire(1).capacity() >= 100);
+    CHECK(pool.acquire(1).capacity() < 100);
+}
+
+void testSharedBetweenThreads() {
+    BufferPool pool(16, 1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, t] {
+            for (int i = 0; i < 10000; ++i) {
+                BufferPool::Buffer buffer = pool.acquire(64);
+                buffer[0] = static_cast<uint8_t>(t);
+                buffer[63] = static_cast<uint8_t>(i);
+                pool.release(std::move(buffer));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(pool.acquire(64).size() == 64);
+}
+
+}
+
+int main() {
+    testAcquireHasRequestedSize();
+    testReleasedCapacityIsReused();
+    testLargeBuffersAreNotRetained();
+    testPoolSizeIsBounded();
+    testSharedBetweenThreads();
+    return TEST_RESULT();
+}
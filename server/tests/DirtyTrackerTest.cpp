@@ -0,0 +1,76 @@
+#include "DirtyTracker.h"
+#include "TestCheck.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+void testStartsClean() {
+    DirtyTracker tracker;
+    CHECK(tracker.empty());
+    CHECK(!tracker.isDirty(0));
+    CHECK(!tracker.isDirty(65535));
+}
+
+void testMarksEachIdOnceInOrder() {
+    DirtyTracker tracker;
+    tracker.mark(5);
+    tracker.mark(2);
+    tracker.mark(5);
+    tracker.mark(9);
+    tracker.mark(2);
+    CHECK(!tracker.empty());
+    CHECK((tracker.dirtyIds() == std::vector<uint16_t>{5, 2, 9}));
+    CHECK(tracker.isDirty(5) && tracker.isDirty(2) && tracker.isDirty(9));
+    CHECK(!tracker.isDirty(3));
+}
+
+void testClearUnmarks() {
+    DirtyTracker tracker;
+    tracker.mark(1);
+    tracker.mark(300);
+    tracker.clear();
+    CHECK(tracker.empty());
+    CHECK(!tracker.isDirty(1));
+    CHECK(!tracker.isDirty(300));
+
+    // Marking again after a clear starts a new list
+    tracker.mark(300);
+    CHECK((tracker.dirtyIds() == std::vector<uint16_t>{300}));
+}
+
+void testGrowsToAnyId() {
+    DirtyTracker tracker;
+    tracker.mark(0);
+    tracker.mark(65535);
+    tracker.mark(1000);
+    CHECK(tracker.isDirty(0) && tracker.isDirty(65535) && tracker.isDirty(1000));
+    CHECK(tracker.dirtyIds().size() == 3);
+    // Growing keeps earlier marks
+    tracker.mark(1);
+    CHECK(tracker.isDirty(0));
+}
+
+void testEveryIdMarkedOnce() {
+    DirtyTracker tracker;
+    for (int round = 0; round < 2; ++round) {
+        for (uint32_t id = 0; id <= 65535; ++id) {
+            tracker.mark(static_cast<uint16_t>(id));
+        }
+    }
+    CHECK(tracker.dirtyIds().size() == 65536);
+    tracker.clear();
+    CHECK(tracker.empty());
+    CHECK(!tracker.isDirty(12345));
+}
+
+}
+
+int main() {
+    testStartsClean();
+    testMarksEachIdOnceInOrder();
+    testClearUnmarks();
+    testGrowsToAnyId();
+    testEveryIdMarkedOnce();
+    return TEST_RESULT();
+}
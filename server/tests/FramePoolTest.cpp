@@ -0,0 +1,82 @@
+#include "utils/FramePool.h"
+#include "TestCheck.h"
+#include <thread>
+
+namespace {
+
+void testAcquireIsEmptyWithCapacity() {
+    FramePool pool;
+    FramePool::Buffer buffer = pool.acquire(256);
+    CHECK(buffer);
+    CHECK(buffer->empty());
+    CHECK(buffer->capacity() >= 256);
+}
+
+// A frame comes back once the pool holds the only reference
+void testReuseAfterLastReferenceDropped() {
+    FramePool pool;
+    FramePool::Buffer frame = pool.acquire(64);
+    frame->assign(64, 0xAB);
+    std::vector<uint8_t>* const raw = frame.get();
+
+    FramePool::Buffer inFlight = frame;  // e.g. held by an asynchronous write
+    frame.reset();
+    FramePool::Buffer other = pool.acquire(64);
+    CHECK(other.get() != raw);
+
+    inFlight.reset();
+    FramePool::Buffer reused = pool.acquire(16);
+    CHECK(reused.get() == raw);
+    CHECK(reused->empty());
+    CHECK(reused->capacity() >= 64);
+}
+
+void testBuffersInUseAreNotHandedOut() {
+    FramePool pool;
+    FramePool::Buffer a = pool.acquire(8);
+    FramePool::Buffer b = pool.acquire(8);
+    FramePool::Buffer c = pool.acquire(8);
+    CHECK(a != b && b != c && a != c);
+}
+
+void testLargeBuffersAreReplaced() {
+    FramePool pool(4, 1024);
+    FramePool::Buffer frame = pool.acquire(4096);
+    std::vector<uint8_t>* const raw = frame.get();
+    frame.reset();
+    FramePool::Buffer next = pool.acquire(16);
+    CHECK(next.get() != raw);
+    CHECK(next->capacity() < 4096);
+}
+
+void testPoolSizeIsBounded() {
+    FramePool pool(2, 1024);
+    FramePool::Buffer a = pool.acquire(8);
+    FramePool::Buffer b = pool.acquire(8);
+    // Not pooled: dropping it frees it, the pool can never hand it out again
+    FramePool::Buffer c = pool.acquire(8);
+    CHECK(c.use_count() == 1);
+    CHECK(a.use_count() == 2);
+}
+
+// References dropped on another thread make the buffer reusable
+void testReleaseOnOtherThread() {
+    FramePool pool(1, 1024);
+    FramePool::Buffer frame = pool.acquire(32);
+    std::vector<uint8_t>* const raw = frame.get();
+    std::thread writer([held = std::move(frame)]() mutable { held.reset(); });
+    writer.join();
+    CHECK(pool.acquire(32).get() == raw);
+}
+
+}
+
+int main() {
+    testAcquireIsEmptyWithCapacity();
+    testReuseAfterLastReferenceDropped();
+    testBuffersInUseAreNotHandedOut();
+    testLargeBuffersAreReplaced();
+    testPoolSizeIsBounded();
+    testReleaseOnOtherThread();
+    return TEST_RESULT();
+}
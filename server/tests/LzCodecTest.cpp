@@ -0,0 +1,160 @@
+#include "utils/LzCodec.h"
+#include "TestCheck.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+// Compresses, checks the size bound and returns whether the data comes back unchanged
+bool roundTrips(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed;
+    LzCodec::compress(data.data(), data.size(), compressed);
+    CHECK(compressed.size() <= LzCodec::maxCompressedSize(data.size()));
+
+    std::vector<uint8_t> decompressed(data.size());
+    if (!LzCodec::decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size())) {
+        return false;
+    }
+    return decompressed == data;
+}
+
+bool decompresses(const std::vector<uint8_t>& compressed, size_t originalSize) {
+    std::vector<uint8_t> out(originalSize);
+    return LzCodec::decompress(compressed.data(), compressed.size(), out.data(), originalSize);
+}
+
+// Level state as the server sends it on join: fixed size tile records that
+// differ only in their ID and row
+std::vector<uint8_t> tileRecords(size_t count) {
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < count; ++i) {
+        const uint16_t id = static_cast<uint16_t>(i + 1);
+        const uint16_t y = static_cast<uint16_t>((i / 100) * 32);
+        const uint8_t record[] = {
+            static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id), 3,
+            static_cast<uint8_t>(y >> 8), static_cast<uint8_t>(y),
+            0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 1};
+        data.insert(data.end(), std::begin(record), std::end(record));
+    }
+    return data;
+}
+
+void testEmptyInput() {
+    std::vector<uint8_t> compressed;
+    LzCodec::compress(nullptr, 0, compressed);
+    CHECK(!compressed.empty());
+    CHECK(compressed.size() <= LzCodec::maxCompressedSize(0));
+    CHECK(decompresses(compressed, 0));
+    CHECK(decompresses({}, 0));
+}
+
+void testShortInputs() {
+    // Below the match search limit everything is stored as literals
+    for (size_t size = 1; size < 13; ++size) {
+        std::vector<uint8_t> data(size, 0xAA);
+        CHECK(roundTrips(data));
+    }
+}
+
+void testRepetitiveTileRecords() {
+    std::vector<uint8_t> data = tileRecords(8000);
+    CHECK(roundTrips(data));
+
+    std::vector<uint8_t> compressed;
+    LzCodec::compress(data.data(), data.size(), compressed);
+    CHECK(compressed.size() * 3 < data.size());
+}
+
+void testLongRuns() {
+    // Longer than the 64 KB window and needing extended length bytes
+    std::vector<uint8_t> zeros(200000, 0);
+    CHECK(roundTrips(zeros));
+
+    std::vector<uint8_t> pattern;
+    for (int i = 0; i < 70000; ++i) {
+        pattern.push_back(static_cast<uint8_t>(i % 3));
+    }
+    CHECK(roundTrips(pattern));
+}
+
+void testRandomData() {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (size_t size : {1u, 13u, 100u, 4096u, 100000u}) {
+        std::vector<uint8_t> data(size);
+        for (uint8_t& b : data) {
+            b = static_cast<uint8_t>(byte(rng));
+        }
+        CHECK(roundTrips(data));
+    }
+
+    // Random data with repeated stretches mixed in
+    std::vector<uint8_t> mixed;
+    while (mixed.size() < 50000) {
+        if (byte(rng) < 128 && mixed.size() > 300) {
+            size_t start = mixed.size() - 1 - static_cast<size_t>(byte(rng));
+            size_t length = 4 + static_cast<size_t>(byte(rng) % 40);
+            for (size_t i = 0; i < length; ++i) {
+                mixed.push_back(mixed[start + i]);
+            }
+        } else {
+            mixed.push_back(static_cast<uint8_t>(byte(rng)));
+        }
+    }
+    CHECK(roundTrips(mixed));
+}
+
+void testRejectsTruncatedInput() {
+    std::vector<uint8_t> data = tileRecords(200);
+    std::vector<uint8_t> compressed;
+    LzCodec::compress(data.data(), data.size(), compressed);
+    CHECK(decompresses(compressed, data.size()));
+
+    for (size_t size = 0; size < compressed.size(); ++size) {
+        std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + size);
+        CHECK(!decompresses(truncated, data.size()));
+    }
+
+    // An extended length byte announced but missing
+    CHECK(!decompresses({0xF0}, 20));
+    CHECK(!decompresses({0x4F, 'a', 'b', 'c', 'd', 4, 0}, 30));
+    // Offset cut off after one byte
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd', 4}, 8));
+}
+
+void testRejectsBadOffsets() {
+    // 4 literals, then a 4 byte match: valid with offset 1 to 4
+    CHECK(decompresses({0x40, 'a', 'b', 'c', 'd', 4, 0}, 8));
+    CHECK(decompresses({0x40, 'a', 'b', 'c', 'd', 1, 0}, 8));
+
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd', 0, 0}, 8));
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd', 5, 0}, 8));
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd', 0, 1}, 8));
+}
+
+void testRejectsRunsPastOriginalSize() {
+    // The match would write past the output
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd', 4, 0}, 6));
+    CHECK(!decompresses({0x4F, 'a', 'b', 'c', 'd', 4, 0, 255, 0}, 100));
+    // The literals would
+    CHECK(!decompresses({0x50, 'a', 'b', 'c', 'd', 'e'}, 4));
+    CHECK(!decompresses({0xF0, 255, 255}, 300));
+    // More literals announced than the input holds
+    CHECK(!decompresses({0x50, 'a', 'b', 'c'}, 5));
+    // Valid input that decodes to less than the expected size
+    CHECK(!decompresses({0x40, 'a', 'b', 'c', 'd'}, 5));
+}
+
+}
+
+int main() {
+    testEmptyInput();
+    testShortInputs();
+    testRepetitiveTileRecords();
+    testLongRuns();
+    testRandomData();
+    testRejectsTruncatedInput();
+    testRejectsBadOffsets();
+    testRejectsRunsPastOriginalSize();
+    return TEST_RESULT();
+}
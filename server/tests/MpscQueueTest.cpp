@@ -0,0 +1,102 @@
+#include "utils/MpscQueue.h"
+#include "TestCheck.h"
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void testFifoOnOneThread() {
+    MpscQueue<int> queue;
+    int value = -1;
+    CHECK(!queue.tryPop(value));
+
+    for (int i = 0; i < 100; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        CHECK(queue.tryPop(value));
+        CHECK(value == i);
+    }
+    CHECK(!queue.tryPop(value));
+
+    // Usable again after running empty
+    queue.push(7);
+    CHECK(queue.tryPop(value));
+    CHECK(value == 7);
+}
+
+void testMoveOnlyItems() {
+    MpscQueue<std::unique_ptr<int>> queue;
+    queue.push(std::make_unique<int>(42));
+    std::unique_ptr<int> out;
+    CHECK(queue.tryPop(out));
+    CHECK(out && *out == 42);
+}
+
+void testDestructorFreesQueuedItems() {
+    auto item = std::make_shared<int>(1);
+    std::weak_ptr<int> watch = item;
+    {
+        MpscQueue<std::shared_ptr<int>> queue;
+        queue.push(std::move(item));
+        CHECK(!watch.expired());
+    }
+    CHECK(watch.expired());
+}
+
+// Every item arrives exactly once and each producer's items stay in order
+void testConcurrentProducers() {
+    constexpr uint32_t Producers = 4;
+    constexpr uint32_t ItemsPerProducer = 50000;
+    MpscQueue<uint32_t> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < Producers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (uint32_t i = 0; i < ItemsPerProducer; ++i) {
+                queue.push((p << 24) | i);
+            }
+        });
+    }
+
+    std::vector<uint32_t> nextExpected(Producers, 0);
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    while (received < Producers * ItemsPerProducer) {
+        uint32_t value = 0;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const uint32_t producer = value >> 24;
+        const uint32_t sequence = value & 0xFFFFFF;
+        if (producer >= Producers || sequence != nextExpected[producer]) {
+            ++outOfOrder;
+        } else {
+            ++nextExpected[producer];
+        }
+        ++received;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+
+    CHECK(outOfOrder == 0);
+    for (uint32_t p = 0; p < Producers; ++p) {
+        CHECK(nextExpected[p] == ItemsPerProducer);
+    }
+    uint32_t extra = 0;
+    CHECK(!queue.tryPop(extra));
+}
+
+}
+
+int main() {
+    testFifoOnOneThread();
+    testMoveOnlyItems();
+    testDestructorFreesQueuedItems();
+    testConcurrentProducers();
+    return TEST_RESULT();
+}
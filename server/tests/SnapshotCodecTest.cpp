@@ -0,0 +1,326 @@
+#include "network/SnapshotCodec.h"
+#include "network/BitStream.h"
+#include "network/NetworkConfig.h"
+#include "object.h"
+#include "TestCheck.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr float PositionStep = 1.0f / (1 << NetworkConfig::SnapshotPositionFractionBits);
+constexpr float VelocityStep = 1.0f / (1 << NetworkConfig::SnapshotVelocityFractionBits);
+constexpr float VelocityMax = ((1 << (NetworkConfig::SnapshotVelocityBits - 1)) - 1) * VelocityStep;
+
+std::vector<uint8_t> encode(const std::vector<ObjectSnapshot>& objects) {
+    ObjectSnapshotRefs refs;
+    for (const ObjectSnapshot& obj : objects) {
+        refs.push_back(&obj);
+    }
+    std::vector<uint8_t> out;
+    SnapshotCodec::encode(refs, out);
+    return out;
+}
+
+bool roundTrip(const std::vector<ObjectSnapshot>& objects, std::vector<ObjectSnapshot>& decoded) {
+    const std::vector<uint8_t> payload = encode(objects);
+    return SnapshotCodec::decode(payload.data(), payload.size(), decoded);
+}
+
+ObjectSnapshot makeObject(ObjectType type, uint16_t id, float x, float y, float vx = 0.0f, float vy = 0.0f) {
+    ObjectSnapshot obj;
+    obj.type = static_cast<uint8_t>(type);
+    obj.id = id;
+    obj.position = Vec2(x, y);
+    obj.velocity = Vec2(vx, vy);
+    return obj;
+}
+
+// Everything but position and velocity survives exactly
+bool sameFields(const ObjectSnapshot& a, const ObjectSnapshot& b) {
+    if (a.type != b.type || a.id != b.id) {
+        return false;
+    }
+    switch (static_cast<ObjectType>(a.type)) {
+        case ObjectType::PLAYER:
+        case ObjectType::MINOTAUR:
+            return a.animState == b.animState && a.direction == b.direction && a.health == b.health;
+        case ObjectType::TILE:
+            return a.tileIndex == b.tileIndex && a.flags == b.flags && a.tilesetIndex == b.tilesetIndex;
+        default:
+            return true;
+    }
+}
+
+void testEmptyPayload() {
+    std::vector<ObjectSnapshot> decoded(3);
+    CHECK(roundTrip({}, decoded));
+    CHECK(decoded.empty());
+}
+
+void testRandomRoundTrip() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-50000.0f, 50000.0f);
+    std::uniform_real_distribution<float> velocity(-VelocityMax, VelocityMax);
+    std::uniform_int_distribution<uint32_t> any(0, std::numeric_limits<uint32_t>::max());
+    const ObjectType types[] = {ObjectType::PLAYER, ObjectType::TILE, ObjectType::ITEM, ObjectType::BULLET,
+                                ObjectType::MINOTAUR};
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<ObjectSnapshot> objects;
+        const size_t count = 1 + any(rng) % 300;
+        for (size_t i = 0; i < count; ++i) {
+            const bool moving = any(rng) % 2 == 0;
+            ObjectSnapshot obj = makeObject(types[any(rng) % 5], static_cast<uint16_t>(any(rng)), position(rng),
+                                            position(rng), moving ? velocity(rng) : 0.0f,
+                                            moving ? velocity(rng) : 0.0f);
+            obj.animState = static_cast<uint8_t>(any(rng) % 16);
+            obj.direction = static_cast<uint8_t>(any(rng) % 8);
+            obj.health = static_cast<int16_t>(any(rng));
+            obj.tileIndex = static_cast<uint8_t>(any(rng));
+            obj.flags = any(rng);
+            obj.tilesetIndex = static_cast<uint16_t>(any(rng));
+            objects.push_back(obj);
+        }
+
+        std::vector<ObjectSnapshot> decoded;
+        CHECK(roundTrip(objects, decoded));
+        CHECK(decoded.size() == objects.size());
+        if (decoded.size() != objects.size()) {
+            continue;
+        }
+        float worstPosition = 0.0f;
+        float worstVelocity = 0.0f;
+        size_t mismatched = 0;
+        for (size_t i = 0; i < objects.size(); ++i) {
+            worstPosition = std::max({worstPosition, std::fabs(decoded[i].position.x - objects[i].position.x),
+                                      std::fabs(decoded[i].position.y - objects[i].position.y)});
+            worstVelocity = std::max({worstVelocity, std::fabs(decoded[i].velocity.x - objects[i].velocity.x),
+                                      std::fabs(decoded[i].velocity.y - objects[i].velocity.y)});
+            if (!sameFields(objects[i], decoded[i])) {
+                ++mismatched;
+            }
+        }
+        // Half a quantization step, plus float rounding at these magnitudes
+        CHECK(worstPosition <= PositionStep / 2 + 0.01f);
+        CHECK(worstPosition <= NetworkConfig::Client::PositionErrorThreshold);
+        CHECK(worstVelocity <= VelocityStep / 2);
+        CHECK(mismatched == 0);
+    }
+}
+
+void testExtremeValues() {
+    std::vector<ObjectSnapshot> objects;
+    objects.push_back(makeObject(ObjectType::PLAYER, 0, -1.0e6f, 1.0e6f));
+    objects.push_back(makeObject(ObjectType::PLAYER, 65535, 1.0e6f, -1.0e6f));
+    objects.back().health = std::numeric_limits<int16_t>::min();
+    objects.push_back(makeObject(ObjectType::MINOTAUR, 128, 0.0f, 0.0f));
+    objects.back().health = std::numeric_limits<int16_t>::max();
+    objects.back().animState = 15;
+    objects.back().direction = 7;
+    objects.push_back(makeObject(ObjectType::TILE, 16384, 0.0625f, -0.0625f));
+    objects.back().flags = std::numeric_limits<uint32_t>::max();
+    objects.back().tileIndex = 255;
+    objects.back().tilesetIndex = 65535;
+
+    std::vector<ObjectSnapshot> decoded;
+    CHECK(roundTrip(objects, decoded));
+    CHECK(decoded.size() == objects.size());
+    for (size_t i = 0; i < decoded.size() && i < objects.size(); ++i) {
+        CHECK(sameFields(objects[i], decoded[i]));
+        CHECK(std::fabs(decoded[i].position.x - objects[i].position.x) <= NetworkConfig::Client::PositionErrorThreshold);
+        CHECK(std::fabs(decoded[i].position.y - objects[i].position.y) <= NetworkConfig::Client::PositionErrorThreshold);
+    }
+}
+
+void testPositionsOutOfRangeAreClampedOrZeroed() {
+    std::vector<ObjectSnapshot> objects;
+    objects.push_back(makeObject(ObjectType::ITEM, 1, std::numeric_limits<float>::max(), -1.0e30f));
+    objects.push_back(makeObject(ObjectType::ITEM, 2, std::nanf(""), 10.0f));
+    std::vector<ObjectSnapshot> decoded;
+    CHECK(roundTrip(objects, decoded));
+    CHECK(decoded.size() == 2);
+    if (decoded.size() == 2) {
+        CHECK(decoded[0].position.x > 1.0e8f);
+        CHECK(decoded[0].position.y < -1.0e8f);
+        CHECK(decoded[1].position.x == 0.0f);
+        CHECK(decoded[1].position.y == 10.0f);
+    }
+}
+
+void testVelocityClamping() {
+    std::vector<ObjectSnapshot> objects;
+    objects.push_back(makeObject(ObjectType::BULLET, 1, 0.0f, 0.0f, 10000.0f, -10000.0f));
+    objects.push_back(makeObject(ObjectType::BULLET, 2, 0.0f, 0.0f, VelocityMax, -VelocityMax));
+    objects.push_back(makeObject(ObjectType::BULLET, 3, 0.0f, 0.0f, std::nanf(""), 0.0f));
+    objects.push_back(makeObject(ObjectType::BULLET, 4, 0.0f, 0.0f, 0.1f, 0.0f));
+    std::vector<ObjectSnapshot> decoded;
+    CHECK(roundTrip(objects, decoded));
+    CHECK(decoded.size() == 4);
+    if (decoded.size() == 4) {
+        CHECK(decoded[0].velocity.x == VelocityMax);
+        CHECK(decoded[0].velocity.y == -VelocityMax);
+        CHECK(decoded[1].velocity.x == VelocityMax);
+        CHECK(decoded[1].velocity.y == -VelocityMax);
+        CHECK(decoded[2].velocity.x == 0.0f);
+        // Moving slower than a step still rounds to the nearest step
+        CHECK(decoded[3].velocity.x == 0.0f);
+    }
+}
+
+void testFrameCoversObjects() {
+    std::vector<ObjectSnapshot> objects;
+    objects.push_back(makeObject(ObjectType::TILE, 1, -10.0f, 5.0f));
+    objects.push_back(makeObject(ObjectType::TILE, 2, 20.0f, 5.0f));
+    const ObjectSnapshot* refs[] = {&objects[0], &objects[1]};
+
+    const SnapshotCodec::Frame frame = SnapshotCodec::frameFor(refs, 2);
+    CHECK(frame.originX == -10 * (1 << NetworkConfig::SnapshotPositionFractionBits));
+    CHECK(frame.originY == 5 * (1 << NetworkConfig::SnapshotPositionFractionBits));
+    CHECK(frame.bitsX == 8);  // A span of 240 steps
+    CHECK(frame.bitsY == 0);  // Same row, no bits at all
+
+    // A single object needs no position bits
+    const SnapshotCodec::Frame single = SnapshotCodec::frameFor(refs, 1);
+    CHECK(single.bitsX == 0 && single.bitsY == 0);
+    CHECK(SnapshotCodec::frameFor(refs, 0).bitsX == 0);
+}
+
+// Parts of a split payload share a frame wider than their own objects
+void testEncodeWithGivenFrame() {
+    std::vector<ObjectSnapshot> objects;
+    objects.push_back(makeObject(ObjectType::ITEM, 1, -500.0f, -500.0f));
+    objects.push_back(makeObject(ObjectType::ITEM, 2, 700.5f, 300.25f));
+    objects.push_back(makeObject(ObjectType::ITEM, 3, 12.0f, 13.0f));
+    const ObjectSnapshot* refs[] = {&objects[0], &objects[1], &objects[2]};
+    const SnapshotCodec::Frame frame = SnapshotCodec::frameFor(refs, 3);
+
+    std::vector<uint8_t> payload;
+    SnapshotCodec::encode(refs + 2, 1, frame, payload);
+    std::vector<ObjectSnapshot> decoded;
+    CHECK(SnapshotCodec::decode(payload.data(), payload.size(), decoded));
+    CHECK(decoded.size() == 1);
+    CHECK(!decoded.empty() && decoded[0].position.x == 12.0f && decoded[0].position.y == 13.0f);
+}
+
+void testSizeMatchesCountedBits() {
+    std::vector<ObjectSnapshot> objects;
+    for (uint16_t i = 0; i < 40; ++i) {
+        objects.push_back(makeObject(i % 2 ? ObjectType::TILE : ObjectType::PLAYER, static_cast<uint16_t>(i * 300),
+                                     i * 32.0f, i * 16.0f, i % 3 ? 0.0f : 50.0f, 0.0f));
+    }
+    ObjectSnapshotRefs refs;
+    for (const ObjectSnapshot& obj : objects) {
+        refs.push_back(&obj);
+    }
+    const SnapshotCodec::Frame frame = SnapshotCodec::frameFor(refs.data(), refs.size());
+    size_t bits = SnapshotCodec::headerBits(refs.size(), frame);
+    for (const ObjectSnapshot* obj : refs) {
+        bits += SnapshotCodec::objectBits(*obj, frame);
+    }
+    CHECK(encode(objects).size() == (bits + 7) / 8);
+}
+
+void testVarintEdges() {
+    const uint32_t values[] = {0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 0x7FFFFFFF, 0xFFFFFFFF};
+    const int32_t signedValues[] = {0, 1, -1, 63, -64, 64, -65, std::numeric_limits<int32_t>::max(),
+                                    std::numeric_limits<int32_t>::min()};
+    std::vector<uint8_t> bytes;
+    BitWriter writer(bytes);
+    writer.write(1, 3);  // Varints need not start on a byte boundary
+    for (uint32_t value : values) {
+        writer.writeVarint(value);
+    }
+    for (int32_t value : signedValues) {
+        writer.writeSignedVarint(value);
+    }
+    writer.write(0xDEADBEEF, 32);
+    writer.finish();
+
+    BitReader reader(bytes.data(), bytes.size());
+    CHECK(reader.read(3) == 1);
+    for (uint32_t value : values) {
+        CHECK(reader.readVarint() == value);
+    }
+    for (int32_t value : signedValues) {
+        CHECK(reader.readSignedVarint() == value);
+    }
+    CHECK(reader.read(32) == 0xDEADBEEF);
+    CHECK(reader.ok());
+
+    // One group per 7 bits, zigzag keeps small negatives in one group
+    std::vector<uint8_t> sized;
+    BitWriter sizeWriter(sized);
+    sizeWriter.writeSignedVarint(-64);
+    sizeWriter.finish();
+    CHECK(sized.size() == 1);
+}
+
+void testReaderRejectsTruncation() {
+    std::vector<uint8_t> bytes = {0xFF};
+    BitReader reader(bytes.data(), bytes.size());
+    CHECK(reader.read(8) == 0xFF);
+    CHECK(reader.ok());
+    CHECK(reader.read(1) == 0);
+    CHECK(!reader.ok());
+
+    // A varint whose continuation bit runs off the end
+    std::vector<uint8_t> open = {0x80, 0x80};
+    BitReader varintReader(open.data(), open.size());
+    varintReader.readVarint();
+    CHECK(!varintReader.ok());
+
+    // More groups than a 32-bit value has
+    std::vector<uint8_t> overlong = {0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+    BitReader overlongReader(overlong.data(), overlong.size());
+    overlongReader.readVarint();
+    CHECK(!overlongReader.ok());
+}
+
+void testDecodeRejectsTruncatedPayloads() {
+    std::vector<ObjectSnapshot> objects;
+    for (uint16_t i = 0; i < 20; ++i) {
+        ObjectSnapshot obj = makeObject(i % 2 ? ObjectType::TILE : ObjectType::MINOTAUR, i, i * 10.0f, -i * 7.0f,
+                                        i % 4 ? 0.0f : 25.0f, 5.0f);
+        obj.flags = 1000u * i;
+        obj.health = static_cast<int16_t>(-i);
+        objects.push_back(obj);
+    }
+    const std::vector<uint8_t> payload = encode(objects);
+    size_t accepted = 0;
+    std::vector<ObjectSnapshot> decoded;
+    for (size_t size = 0; size < payload.size(); ++size) {
+        if (SnapshotCodec::decode(payload.data(), size, decoded)) {
+            ++accepted;
+        }
+        CHECK(decoded.empty());
+    }
+    CHECK(accepted == 0);
+
+    // A count larger than the payload could hold
+    std::vector<uint8_t> bogus;
+    BitWriter writer(bogus);
+    writer.writeVarint(1000);
+    writer.finish();
+    CHECK(!SnapshotCodec::decode(bogus.data(), bogus.size(), decoded));
+}
+
+}
+
+int main() {
+    testEmptyPayload();
+    testRandomRoundTrip();
+    testExtremeValues();
+    testPositionsOutOfRangeAreClampedOrZeroed();
+    testVelocityClamping();
+    testFrameCoversObjects();
+    testEncodeWithGivenFrame();
+    testSizeMatchesCountedBits();
+    testVarintEdges();
+    testReaderRejectsTruncation();
+    testDecodeRejectsTruncatedPayloads();
+    return TEST_RESULT();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <iostream>
+
+/**
+ * Minimal checks for the unit tests. A failed CHECK prints its location and
+ * is counted; main() returns TEST_RESULT() so ctest sees the failure.
+ */
+namespace test {
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++test::failures(); \
+        } \
+    } while (0)
+
+#define TEST_RESULT() (test::failures() == 0 ? 0 : 1)
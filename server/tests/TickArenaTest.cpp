@@ -0,0 +1,112 @@
+#include "utils/TickArena.h"
+#include "TestCheck.h"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+bool isAligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+void testAllocationsAreAligned() {
+    TickArena arena(1024);
+    for (size_t alignment : {size_t(1), size_t(2), size_t(4), size_t(8), size_t(16), size_t(64)}) {
+        (void)arena.allocate(1, 1);  // Leave the offset odd
+        void* p = arena.allocate(24, alignment);
+        CHECK(isAligned(p, alignment));
+    }
+}
+
+void testAllocationsDoNotOverlap() {
+    TickArena arena(256);
+    std::vector<uint8_t*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        auto* p = static_cast<uint8_t*>(arena.allocate(40, 8));
+        for (int j = 0; j < 40; ++j) {
+            p[j] = static_cast<uint8_t>(i);
+        }
+        blocks.push_back(p);
+    }
+    bool intact = true;
+    for (int i = 0; i < 64; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            intact = intact && blocks[i][j] == static_cast<uint8_t>(i);
+        }
+    }
+    CHECK(intact);
+}
+
+void testUsedAndHighWater() {
+    TickArena arena(1024);
+    (void)arena.allocate(100, 1);
+    (void)arena.allocate(50, 1);
+    CHECK(arena.used() == 150);
+    arena.reset();
+    CHECK(arena.used() == 0);
+    CHECK(arena.highWater() == 150);
+    (void)arena.allocate(10, 1);
+    arena.reset();
+    CHECK(arena.highWater() == 150);
+}
+
+void testResetRewinds() {
+    TickArena arena(1024);
+    void* first = arena.allocate(64, 16);
+    arena.reset();
+    CHECK(arena.allocate(64, 16) == first);
+}
+
+// A tick that outgrew the first block fits in one block on the next tick
+void testResetMergesBlocks() {
+    TickArena arena(256);
+    for (int i = 0; i < 32; ++i) {
+        (void)arena.allocate(64, 8);
+    }
+    const size_t needed = arena.used();
+    arena.reset();
+
+    auto* base = static_cast<uint8_t*>(arena.allocate(64, 8));
+    bool contiguous = true;
+    for (int i = 1; i < 32; ++i) {
+        auto* p = static_cast<uint8_t*>(arena.allocate(64, 8));
+        contiguous = contiguous && p == base + i * 64;
+    }
+    CHECK(contiguous);
+    CHECK(arena.used() == needed);
+}
+
+void testLargerThanBlockAllocation() {
+    TickArena arena(64);
+    void* p = arena.allocate(4096, 32);
+    CHECK(isAligned(p, 32));
+    static_cast<uint8_t*>(p)[4095] = 1;
+}
+
+void testPmrContainers() {
+    TickArena arena(128);
+    for (int tick = 0; tick < 3; ++tick) {
+        std::pmr::vector<uint64_t> values(&arena);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        CHECK(values.size() == 1000 && values[999] == 999);
+        CHECK(isAligned(values.data(), alignof(uint64_t)));
+        values = std::pmr::vector<uint64_t>(&arena);
+        arena.reset();
+    }
+}
+
+}
+
+int main() {
+    testAllocationsAreAligned();
+    testAllocationsDoNotOverlap();
+    testUsedAndHighWater();
+    testResetRewinds();
+    testResetMergesBlocks();
+    testLargerThanBlockAllocation();
+    testPmrContainers();
+    return TEST_RESULT();
+}
@@ -0,0 +1,127 @@
+#include "utils/TripleBuffer.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+void testNothingPublished() {
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.update());
+}
+
+void testPublishAndRead() {
+    TripleBuffer<int> buffer;
+    buffer.writeBuffer() = 1;
+    CHECK(!buffer.publish());
+    CHECK(buffer.update());
+    CHECK(buffer.readBuffer() == 1);
+    // Nothing newer yet, the read buffer stays
+    CHECK(!buffer.update());
+    CHECK(buffer.readBuffer() == 1);
+}
+
+void testLatestWins() {
+    TripleBuffer<int> buffer;
+    buffer.writeBuffer() = 1;
+    CHECK(!buffer.publish());
+    buffer.writeBuffer() = 2;
+    // The first publish was never picked up
+    CHECK(buffer.publish());
+    CHECK(buffer.update());
+    CHECK(buffer.readBuffer() == 2);
+    CHECK(!buffer.update());
+}
+
+void testOverwrittenBufferIsHandedBack() {
+    TripleBuffer<int> buffer;
+    buffer.writeBuffer() = 1;
+    buffer.publish();
+    buffer.writeBuffer() = 2;
+    CHECK(buffer.publish());
+    // The unread buffer is the new write buffer, still holding what was published in it
+    CHECK(buffer.writeBuffer() == 1);
+
+    CHECK(buffer.update());
+    buffer.writeBuffer() = 3;
+    // Picked up in between, nothing was dropped
+    CHECK(!buffer.publish());
+}
+
+void testNeverWritesTheReadBuffer() {
+    TripleBuffer<int> buffer;
+    for (int i = 0; i < 10; ++i) {
+        buffer.writeBuffer() = i;
+        buffer.publish();
+        if (i % 3 == 0) {
+            CHECK(buffer.update());
+        }
+        CHECK(&buffer.writeBuffer() != &buffer.readBuffer());
+    }
+}
+
+struct Payload {
+    uint64_t sequence = 0;
+    uint64_t check = 0;
+};
+
+// The consumer only ever sees whole payloads, in increasing order
+void testConcurrentProducerAndConsumer() {
+    constexpr uint64_t Publishes = 200000;
+    TripleBuffer<Payload> buffer;
+    std::atomic<bool> done{false};
+    uint64_t dropped = 0;
+
+    std::thread producer([&] {
+        for (uint64_t i = 1; i <= Publishes; ++i) {
+            Payload& payload = buffer.writeBuffer();
+            payload.sequence = i;
+            payload.check = ~i;
+            if (buffer.publish()) {
+                ++dropped;
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t last = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    uint64_t reads = 0;
+    while (true) {
+        const bool finished = done.load(std::memory_order_acquire);
+        if (buffer.update()) {
+            const Payload& payload = buffer.readBuffer();
+            if (payload.check != ~payload.sequence) {
+                ++torn;
+            }
+            if (payload.sequence <= last) {
+                ++backwards;
+            }
+            last = payload.sequence;
+            ++reads;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(last == Publishes);
+    // Every publish was either read or reported as overwritten
+    CHECK(reads + dropped == Publishes);
+}
+
+}
+
+int main() {
+    testNothingPublished();
+    testPublishAndRead();
+    testLatestWins();
+    testOverwrittenBufferIsHandedBack();
+    testNeverWritesTheReadBuffer();
+    testConcurrentProducerAndConsumer();
+    return TEST_RESULT();
+}